@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
@@ -12,11 +13,13 @@
 
 #include "cyclus.h"
 #include "hdf5_back.h"
+#include "partition_back.h"
 #include "pyhooks.h"
 #include "pyne.h"
 #include "query_backend.h"
 #include "sim_init.h"
 #include "sqlite_back.h"
+#include "startup_profile.h"
 #include "xml_file_loader.h"
 #include "xml_flat_loader.h"
 
@@ -46,6 +49,10 @@ int EarlyExitArgs(const ArgInfo& ai);
 // Using cli flags, retrieves and sets global params for the simulation.
 void GetSimInfo(ArgInfo* ai);
 
+// Prints the start-up profile and writes it as JSON if requested. Does
+// nothing unless start-up profiling is enabled.
+void ReportStartup(const ArgInfo& ai);
+
 static std::string usage = "Usage:   cyclus [opts] [input-file]";
 
 //-----------------------------------------------------------------------
@@ -54,23 +61,45 @@ static std::string usage = "Usage:   cyclus [opts] [input-file]";
 int main(int argc, char* argv[]) {
   // Close all dlopen'd modules AFTER everything else destructs
   DynamicModule::Closer cl;
-  PyStart();
+
+  // profiling is enabled before the options are parsed so that it covers
+  // the interpreter start
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--profile-startup", 17) == 0) {
+      StartupProfile::Enable();
+    }
+  }
+  {
+    ProfileScope prof("PyStart");
+    PyStart();
+  }
 
   // Tell ENV the path between the cwd and the cyclus executable
   std::string path = Env::PathBase(argv[0]);
 
   // Tell pyne about the path to nuc data
-  Env::SetNucDataPath();
+  {
+    ProfileScope prof("Env::SetNucDataPath");
+    Env::SetNucDataPath();
+  }
 
   // Handle cli option flags
   ArgInfo ai;
-  int ret = ParseCliArgs(&ai, argc, argv);
+  int ret;
+  {
+    ProfileScope prof("ParseCliArgs");
+    ret = ParseCliArgs(&ai, argc, argv);
+  }
   if (ret > -1) {
     return ret;
   }
   GetSimInfo(&ai);
-  ret = EarlyExitArgs(ai);
+  {
+    ProfileScope prof("EarlyExitArgs");
+    ret = EarlyExitArgs(ai);
+  }
   if (ret > -1) {
+    ReportStartup(ai);
     return ret;
   }
 
@@ -126,25 +155,40 @@ int main(int argc, char* argv[]) {
   RecBackend::Deleter bdel;
   Recorder rec;  // Must be after backend deleter because ~Rec does flushing
 
-  std::string ext = fs::path(ai.output_path).extension().string();
-  std::string stem = fs::path(ai.output_path).stem().string();
-  if (ext == ".h5") {
-    fback = new Hdf5Back(ai.output_path.c_str());
-  } else {
-    fback = new SqliteBack(ai.output_path);
+  {
+    ProfileScope prof("open output");
+    std::string ext = fs::path(ai.output_path).extension().string();
+    std::string stem = fs::path(ai.output_path).stem().string();
+    if (PartitionBack::IsStore(ai.output_path)) {
+      fback = new PartitionBack(ai.output_path);
+    } else if (ext == ".h5") {
+      fback = new Hdf5Back(ai.output_path.c_str());
+    } else {
+      fback = new SqliteBack(ai.output_path);
+    }
   }
   rec.RegisterBackend(fback);
   bdel.Add(fback);
 
   // Try to detect schema type
-  std::stringstream input;
-  LoadStringstreamFromFile(input, infile, format);
-  boost::shared_ptr<XMLParser> parser =
-      boost::shared_ptr<XMLParser>(new XMLParser());
-  parser->Init(input);
-  InfileTree tree(*parser);
-  std::string schema_type =
-      OptionalQuery<std::string>(&tree, "/simulation/schematype", "");
+  std::string schema_type;
+  {
+    ProfileScope prof("detect schema type");
+    std::string query = "/simulation/schematype";
+    std::string json;
+    if (LoadJsonFromFile(json, infile, format)) {
+      JsonInfileTree tree(json);
+      schema_type = OptionalQuery<std::string>(&tree, query, "");
+    } else {
+      std::stringstream input;
+      LoadStringstreamFromFile(input, infile, format);
+      boost::shared_ptr<XMLParser> parser =
+          boost::shared_ptr<XMLParser>(new XMLParser());
+      parser->Init(input);
+      InfileTree tree(*parser);
+      schema_type = OptionalQuery<std::string>(&tree, query, "");
+    }
+  }
   if (schema_type == "flat" && !ai.flat_schema) {
     std::cout << "flat schema tag detected - switching to flat input schema\n";
     ai.flat_schema = true;
@@ -161,6 +205,7 @@ int main(int argc, char* argv[]) {
       ms_print = true;
     }
     try {
+      ProfileScope prof("load input");
       if (ai.flat_schema) {
         XMLFlatLoader l(&rec, fback, ai.schema_path, infile, format, ms_print);
         l.LoadSim();
@@ -172,6 +217,7 @@ int main(int argc, char* argv[]) {
       CLOG(LEV_ERROR) << e.what();
       return 1;
     }
+    ProfileScope prof("SimInit::Init");
     si.Init(&rec, fback);
   } else {
     // Read output db and restart simulation from specified simid and timestep
@@ -197,16 +243,22 @@ int main(int argc, char* argv[]) {
     RecBackend::Deleter bdel;
 
     std::string ext = dbfile.extension().string();
-    if (ext == ".h5") {
+    if (PartitionBack::IsStore(dbfile.string())) {
+      rback = new PartitionBack(dbfile.string());
+    } else if (ext == ".h5") {
       rback = new Hdf5Back(dbfile.c_str());
     } else {
       rback = new SqliteBack(dbfile.c_str());
     }
     bdel.Add(rback);
 
-    si.Restart(rback, simid, t);
+    {
+      ProfileScope prof("SimInit::Restart");
+      si.Restart(rback, simid, t);
+    }
     si.recorder()->RegisterBackend(fback);
   }
+  ReportStartup(ai);
 
   char* CYCLUS_NO_CATCH = getenv("CYCLUS_NO_CATCH");
   if( CYCLUS_NO_CATCH !=NULL && CYCLUS_NO_CATCH != "0" ){
@@ -258,7 +310,8 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
       ("no-mem", "exclude memory log statement from logger output")
       ("verb,v", po::value<std::string>(),
        "log verbosity. integer from 0 (quiet) to 11 (verbose).")
-      ("output-path,o", po::value<std::string>(), "output path")
+      ("output-path,o", po::value<std::string>(),
+       "output path, a directory is a store shared by many simulations")
       ("input-file,i", po::value<std::string>(),
        "input file, may be a path or a raw string")
       ("format,f", po::value<std::string>()->default_value("none"),
@@ -280,6 +333,10 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
       ("py-to-json", po::value<std::string>(), "*.py input file")
       ("py-to-xml", po::value<std::string>(), "*.py input file")
       ("xml-to-py", po::value<std::string>(), "*.xml input file")
+      ("profile-startup",
+       "print a timing and memory breakdown of the start-up phases")
+      ("profile-startup-json", po::value<std::string>(),
+       "profile the start-up and also write the breakdown as JSON to a file")
       ;
 
   po::variables_map vm;
@@ -530,3 +587,15 @@ void GetSimInfo(ArgInfo* ai) {
     ai->output_path = ai->vm["output-path"].as<std::string>();
   }
 }
+
+void ReportStartup(const ArgInfo& ai) {
+  if (!StartupProfile::enabled()) {
+    return;
+  }
+  std::cout << "Start-up profile:\n" << StartupProfile::ToTable() << "\n";
+  if (ai.vm.count("profile-startup-json") > 0) {
+    std::string path = ai.vm["profile-startup-json"].as<std::string>();
+    std::ofstream f(path.c_str());
+    f << StartupProfile::ToJson();
+  }
+}
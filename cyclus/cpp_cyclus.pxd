@@ -1,5 +1,5 @@
 """C++ header wrapper for specific parts of cyclus."""
-from libc.stdint cimport uint64_t
+from libc.stdint cimport int64_t, uint64_t
 from libcpp.map cimport map
 from libcpp.set cimport set
 from libcpp.vector cimport vector
@@ -184,6 +184,32 @@ cdef extern from "hdf5_back.h" namespace "cyclus":
         Hdf5Back(std_string) except +
 
 
+cdef extern from "columnar_back.h" namespace "cyclus":
+
+    cdef cppclass ColumnarBack(RecBackend):
+        cppclass Column:
+            std_string field
+            char format
+            int itemsize
+            cpp_bool encoded
+            vector[char] data
+            vector[hold_any] values
+
+        cppclass Table:
+            vector[Column] cols
+            int nrows
+
+        ColumnarBack() except +
+        set[std_string] Tables() except +
+        Table& GetTable(std_string) except +
+        cpp_bool DropTable(std_string) except +
+        void Clear() except +
+        cpp_bool store_all_tables() except +
+        void store_all_tables(cpp_bool) except +
+        set[std_string] registry() except +
+        void registry(set[std_string]) except +
+
+
 cdef extern from "dynamic_module.h" namespace "cyclus":
 
     cdef cppclass AgentSpec:
@@ -372,10 +398,10 @@ cdef extern from "resource.h" namespace "cyclus":
     cdef cppclass Resource:
         ctypedef shared_ptr[Resource] Ptr
         Resource()
-        const int obj_id()
-        const int state_id()
+        const int64_t obj_id()
+        const int64_t state_id()
         void BumpStateId()
-        int qual_id()
+        int64_t qual_id()
         const ResourceType type()
         shared_ptr[Resource] Clone()
         void Record(Context*)
@@ -395,7 +421,7 @@ cdef extern from "composition.h" namespace "cyclus":
         shared_ptr[Composition] CreateFromAtom(CompMap)
         @staticmethod
         shared_ptr[Composition] CreateFromMass(CompMap)
-        int id()
+        int64_t id()
         CompMap& atom()
         CompMap& mass()
         shared_ptr[Composition] Decay(int)
@@ -867,9 +893,9 @@ cdef extern from "toolkit/res_map.h" namespace "cyclus::toolkit":
         ctypedef map[K, shared_ptr[R]].iterator iterator
         ctypedef map[K, shared_ptr[R]].const_iterator const_iterator
 
-        ctypedef map[K, int] obj_type
-        ctypedef map[K, int].iterator obj_iterator
-        ctypedef map[K, int].const_iterator const_obj_iterator
+        ctypedef map[K, int64_t] obj_type
+        ctypedef map[K, int64_t].iterator obj_iterator
+        ctypedef map[K, int64_t].const_iterator const_obj_iterator
 
         int size()
         double quantity()
@@ -332,6 +332,7 @@ CYTHON_TYPES = {
     # type system types
     'BOOL': 'cpp_bool',
     'INT': 'int',
+    'LONG': 'int64_t',
     'FLOAT': 'float',
     'DOUBLE': 'double',
     'STRING': 'std_string',
@@ -344,6 +345,7 @@ CYTHON_TYPES = {
     # C++ normal types
     'bool': 'cpp_bool',
     'int': 'int',
+    'int64_t': 'int64_t',
     'float': 'float',
     'double': 'double',
     'std::string': 'std_string',
@@ -373,6 +375,7 @@ FUNCNAMES = {
     # type system types
     'BOOL': 'bool',
     'INT': 'int',
+    'LONG': 'long',
     'FLOAT': 'float',
     'DOUBLE': 'double',
     'STRING': 'std_string',
@@ -385,6 +388,7 @@ FUNCNAMES = {
     # C++ normal types
     'bool': 'bool',
     'int': 'int',
+    'int64_t': 'long',
     'float': 'float',
     'double': 'double',
     'std::string': 'std_string',
@@ -407,6 +411,7 @@ CLASSNAMES = {
     # type system types
     'BOOL': 'Bool',
     'INT': 'Int',
+    'LONG': 'Long',
     'FLOAT': 'Float',
     'DOUBLE': 'Double',
     'STRING': 'String',
@@ -419,6 +424,7 @@ CLASSNAMES = {
     # C++ normal types
     'bool': 'Bool',
     'int': 'Int',
+    'int64_t': 'Long',
     'float': 'Float',
     'double': 'Double',
     'std::string': 'String',
@@ -443,6 +449,7 @@ CLASSNAMES = {
 VARS_TO_PY = {
     'bool': '{var}',
     'int': '{var}',
+    'int64_t': '{var}',
     'float': '{var}',
     'double': '{var}',
     'std::string': 'bytes({var}).decode()',
@@ -457,6 +464,7 @@ VARS_TO_PY = {
 VARS_TO_CPP = {
     'bool': '<bint> {var}',
     'int': '<int> {var}',
+    'int64_t': '<int64_t> {var}',
     'float': '<float> {var}',
     'double': '<double> {var}',
     'std::string': 'str_py_to_cpp({var})',
@@ -480,6 +488,7 @@ TEMPLATE_ARGS = {
 NPTYPES = {
     'bool': 'np.NPY_BOOL',
     'int': 'np.NPY_INT32',
+    'int64_t': 'np.NPY_INT64',
     'float': 'np.NPY_FLOAT32',
     'double': 'np.NPY_FLOAT64',
     'std::string': 'np.NPY_OBJECT',
@@ -500,6 +509,7 @@ NPTYPES = {
 NEW_PY_INSTS = {
     'bool': 'False',
     'int': '0',
+    'int64_t': '0',
     'float': '0.0',
     'double': '0.0',
     'std::string': '""',
@@ -522,6 +532,7 @@ TO_PY_CONVERTERS = {
     # base types
     'bool': ('', '', '{var}'),
     'int': ('', '', '{var}'),
+    'int64_t': ('', '', '{var}'),
     'float': ('', '', '{var}'),
     'double': ('', '', '{var}'),
     'std::string': ('\n', '\npy{var} = {var}\npy{var} = py{var}.decode()\n',
@@ -626,6 +637,7 @@ TO_CPP_CONVERTERS = {
     # base types
     'bool': ('', '', '<bint> {var}'),
     'int': ('', '', '<int> {var}'),
+    'int64_t': ('', '', '<int64_t> {var}'),
     'float': ('', '', '<float> {var}'),
     'double': ('', '', '<double> {var}'),
     'std::string': ('cdef bytes b_{var}',
@@ -847,6 +859,7 @@ from libcpp.typeinfo cimport type_info
 from cython.operator cimport dereference as deref
 from cython.operator cimport preincrement as inc
 from cython.operator cimport typeid
+from libc.stdint cimport int64_t
 from libc.stdlib cimport malloc, free
 from libc.string cimport memcpy
 from libcpp cimport bool as cpp_bool
@@ -12,17 +12,14 @@ from cyclus cimport cpp_cyclus
 from cyclus cimport lib
 
 
-cdef cppclass CyclusMemBack "CyclusMemBack" (cpp_cyclus.RecBackend):
-    # Recorder backend interface
-    void Notify(cpp_cyclus.DatumList) except +
-    std_string Name() except +
-    void Flush() except +
-    void Close() except +
-    # Extra interface
-    dict Init() except +
-    PyObject* cache
-    cpp_bool store_all_tables
-    std_set[std_string] registry
+cdef class _ColumnBuffer:
+    # Exposes the data buffer of a column through the buffer protocol
+    cdef char* ptr
+    cdef bytes fmt
+    cdef Py_ssize_t shape[1]
+    cdef Py_ssize_t strides[1]
+    cdef Py_ssize_t itemsize
+    cdef object owner
 
 
 cdef class _MemBack(lib._FullBackend):
@@ -7,9 +7,7 @@ from libcpp.utility cimport pair as std_pair
 from libcpp.string cimport string as std_string
 from libcpp cimport bool as cpp_bool
 
-from cpython cimport (PyObject, PyDict_New, PyDict_Contains,
-    PyDict_GetItemString, PyDict_SetItemString, PyString_FromString,
-    PyBytes_FromString, PyDict_GetItem, PyDict_SetItem)
+from cpython cimport PyObject
 
 from cyclus cimport cpp_cyclus
 from cyclus cimport lib
@@ -20,7 +18,7 @@ from cyclus.typesystem cimport (py_to_any, any_to_py, str_py_to_cpp,
     std_set_std_string_to_cpp)
 
 from collections import deque
-from collections.abc import Set
+from collections.abc import Set, MutableMapping
 from ast import (Name, Compare, Load, Eq, NotEq, Lt, LtE, Gt, GtE,
     BinOp, BitAnd, Expression)
 
@@ -33,95 +31,119 @@ np.import_array()
 np.import_ufunc()
 
 
-cdef cppclass CyclusMemBack "CyclusMemBack" (cpp_cyclus.RecBackend):
-    # A C++ class that acts as a rec backend, but stores its data in
-    # memory in a Python friendly format.
+cdef class _ColumnBuffer:
+    """A read-only view of the data buffer of a column of the C++ backend,
+    exposed through the buffer protocol so that NumPy can copy it wholesale.
+    """
 
-    dict Init():
-        """Initilaizer that returns cache, so that we can keep an extra
-        reference to it around.
-        """
-        this.store_all_tables = 1  # set to true, by default
-        c = {}
-        this.cache = <PyObject*> c
-        return c
-
-    void Notify(cpp_cyclus.DatumList data):
-        """Stores the data in a cache."""
-        cdef std_map[std_string, cpp_cyclus.DatumList] groups
-        cdef std_pair[std_string, cpp_cyclus.DatumList] group
-        cdef cpp_cyclus.Datum* d
-        cdef std_pair[const char*, cpp_cyclus.hold_any] val
-        cdef std_string name, cpp_field
-        cdef dict g, res
-        cdef PyObject* pyobval
-        cdef object results, pyval
-        cdef int key_exists, i
-        cdef list fields
-        # check if there is anything to do
-        if not this.store_all_tables and this.registry.size() == 0:
-            return
-        if data.size() == 0:
-            return
-        # combine into like groups
-        if this.store_all_tables:
-            for d in data:
-                name = d.title()
-                groups[name].push_back(d)
-        else:
-            for d in data:
-                name = d.title()
-                if this.registry.count(name) == 0:
-                    continue
-                groups[name].push_back(d)
-            if groups.size() == 0:
-                # no tables seen that are in the registry
-                return
-        # convert groups
-        for group in groups:
-            # init group
-            res = {}
-            fields = []
-            d = group.second.front()
-            for cpp_field in d.fields():
-                field = std_string_to_py(cpp_field)
-                fields.append(field)
-                res[field] = []
-            # fill group
-            name = group.first
-            for d in group.second:
-                i = 0
-                for val in d.vals():
-                    res[fields[i]].append(any_to_py(val.second))
-                    i += 1
-            results = pd.DataFrame(res, columns=fields[:])
-            pyname = std_string_to_py(name)
-            key_exists = PyDict_Contains(<object> this.cache, pyname)
-            if key_exists:
-                pyobval = PyDict_GetItem(<object> this.cache, pyname)
-                pyval = <object> pyobval
-                results = pyval.append(results, ignore_index=True)
-            PyDict_SetItem(<object> this.cache, pyname, results)
-
-    std_string Name():
-        """The name of the backend"""
-        return std_string(b"<Python In-Memory Backend>")
-
-    void Flush():
-        """No-op for in-memory"""
+    def __getbuffer__(self, Py_buffer* buffer, int flags):
+        buffer.buf = self.ptr
+        buffer.format = self.fmt
+        buffer.internal = NULL
+        buffer.itemsize = self.itemsize
+        buffer.len = self.shape[0] * self.itemsize
+        buffer.ndim = 1
+        buffer.obj = self
+        buffer.readonly = 1
+        buffer.shape = self.shape
+        buffer.strides = self.strides
+        buffer.suboffsets = NULL
+
+    def __releasebuffer__(self, Py_buffer* buffer):
         pass
 
-    void Close():
-        """Closes the In-memory backend by setting the cache to None."""
-        c = None
-        this.cache = <PyObject*> c
+
+cdef object column_to_array(cpp_cyclus.ColumnarBack.Column* col, int nrows,
+                            object owner):
+    """Converts a column of the C++ backend into a NumPy array. Data buffers
+    are copied in one go, only the distinct values of encoded columns and the
+    values of object columns are converted one by one.
+    """
+    cdef int i
+    cdef np.ndarray values
+    cdef _ColumnBuffer buf
+    if col.format == 0:
+        arr = np.empty(nrows, dtype=object)
+        for i in range(nrows):
+            arr[i] = any_to_py(col.values[i])
+        return arr
+    if nrows == 0:
+        arr = np.empty(0, dtype=chr(col.format))
+    else:
+        buf = _ColumnBuffer()
+        buf.ptr = col.data.data()
+        buf.fmt = bytes(chr(col.format).encode())
+        buf.shape[0] = nrows
+        buf.strides[0] = col.itemsize
+        buf.itemsize = col.itemsize
+        buf.owner = owner
+        arr = np.array(buf, copy=True)
+    if not col.encoded:
+        return arr
+    values = np.empty(col.values.size(), dtype=object)
+    for i in range(col.values.size()):
+        values[i] = any_to_py(col.values[i])
+    return values[arr]
+
+
+class _ColumnCache(MutableMapping):
+    """The table frames of an in-memory backend, keyed by table name. Frames
+    of recorded tables are built from the C++ column buffers on first access,
+    and are only rebuilt once more rows have been recorded. Other frames,
+    e.g. those loaded from a fallback, are stored as is.
+    """
+
+    def __init__(self, back):
+        self._back = back
+        self._frames = {}
+        self._nrows = {}
+
+    def __getitem__(self, key):
+        nrows = self._back._table_nrows(key)
+        if nrows is None:
+            return self._frames[key]
+        if self._nrows.get(key, None) != nrows:
+            self._frames[key] = self._back._table_frame(key)
+            self._nrows[key] = nrows
+        return self._frames[key]
+
+    def __setitem__(self, key, value):
+        self._frames[key] = value
+        nrows = self._back._table_nrows(key)
+        if nrows is not None:
+            self._nrows[key] = nrows
+
+    def __delitem__(self, key):
+        dropped = self._back._drop_table(key)
+        self._nrows.pop(key, None)
+        if key in self._frames:
+            del self._frames[key]
+        elif not dropped:
+            raise KeyError(key)
+
+    def __contains__(self, key):
+        return key in self._frames or self._back._table_nrows(key) is not None
+
+    def _keys(self):
+        return set(self._frames.keys()) | self._back._table_names()
+
+    def __iter__(self):
+        return iter(self._keys())
+
+    def __len__(self):
+        return len(self._keys())
+
+    def clear(self):
+        self._back._clear_tables()
+        self._frames.clear()
+        self._nrows.clear()
 
 
 cdef class _MemBack(lib._FullBackend):
 
     def __cinit__(self, registry=True, fallback=None):
-        self.ptx = new CyclusMemBack()
-        self.cache = (<CyclusMemBack*> self.ptx).Init()
+        self.ptx = <cpp_cyclus.RecBackend*> new cpp_cyclus.ColumnarBack()
+        self.cache = _ColumnCache(self)
         self._registry = None
         self.registry = registry
         self.fallback = fallback
@@ -132,8 +154,8 @@ cdef class _MemBack(lib._FullBackend):
         # Note that we have to do it this way since self.ptx is void*
         if self.ptx == NULL:
             return
-        cdef CyclusMemBack* cpp_ptx = <CyclusMemBack*> self.ptx
-        cpp_ptx.Close()
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
         del cpp_ptx
         self.ptx = NULL
 
@@ -194,9 +216,11 @@ cdef class _MemBack(lib._FullBackend):
         # this is a no-op
 
     def close(self):
-        """Closes the backend, flushing it in the process."""
+        """Closes the backend, flushing it in the process and discarding the
+        recorded tables.
+        """
         self.flush()  # just in case
-        (<CyclusMemBack*> self.ptx).Close()
+        (<cpp_cyclus.ColumnarBack*> self.ptx).Clear()
         self.cache = None
 
     @property
@@ -212,7 +236,7 @@ cdef class _MemBack(lib._FullBackend):
         """Whether or not the backend will store all tables or only
         those in the registry.
         """
-        return bool_to_py((<CyclusMemBack*> self.ptx).store_all_tables)
+        return bool_to_py((<cpp_cyclus.ColumnarBack*> self.ptx).store_all_tables())
 
     @property
     def registry(self):
@@ -224,28 +248,31 @@ cdef class _MemBack(lib._FullBackend):
         old cache values.
         """
         if self._registry is None:
-            r = std_set_std_string_to_py((<CyclusMemBack*> self.ptx).registry)
+            r = std_set_std_string_to_py(
+                (<cpp_cyclus.ColumnarBack*> self.ptx).registry())
             self._registry = frozenset(r)
         return self._registry
 
     @registry.setter
     def registry(self, val):
-        cdef CyclusMemBack* cpp_ptx = <CyclusMemBack*> self.ptx
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
+        cdef std_set[std_string] empty
         cache = self.cache
         if val is None or isinstance(val, bool):
-            cpp_ptx.registry.clear()
+            cpp_ptx.registry(empty)
             if val:
-                cpp_ptx.store_all_tables = True
+                cpp_ptx.store_all_tables(True)
             else:
-                cpp_ptx.store_all_tables = False
+                cpp_ptx.store_all_tables(False)
                 cache.clear()
             self._registry = None
         else:
             if not isinstance(val, Set):
                 val = frozenset(val)
             old = self.registry
-            cpp_ptx.registry = std_set_std_string_to_cpp(val)
-            cpp_ptx.store_all_tables = False
+            cpp_ptx.registry(std_set_std_string_to_cpp(val))
+            cpp_ptx.store_all_tables(False)
             self._registry = None
             # find keys in the old registry but not in the new one and
             # also in the current cache. Then remove them.
@@ -253,6 +280,55 @@ cdef class _MemBack(lib._FullBackend):
             for key in dirty_keys:
                 del cache[key]
 
+    #
+    # Column buffer access
+    #
+    def _table_names(self):
+        """The names of the tables recorded by the C++ backend."""
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
+        return std_set_std_string_to_py(cpp_ptx.Tables())
+
+    def _table_nrows(self, table):
+        """The number of rows recorded for a table by the C++ backend, or None
+        if the table has not been recorded.
+        """
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
+        cdef std_string name = str_py_to_cpp(table)
+        if cpp_ptx.Tables().count(name) == 0:
+            return None
+        return cpp_ptx.GetTable(name).nrows
+
+    def _table_frame(self, table):
+        """Builds a data frame from the column buffers of a recorded table."""
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
+        cdef cpp_cyclus.ColumnarBack.Table* tbl = \
+            &cpp_ptx.GetTable(str_py_to_cpp(table))
+        cdef cpp_cyclus.ColumnarBack.Column* col
+        cdef int i
+        res = {}
+        fields = []
+        for i in range(tbl.cols.size()):
+            col = &tbl.cols[i]
+            field = std_string_to_py(col.field)
+            fields.append(field)
+            res[field] = column_to_array(col, tbl.nrows, self)
+        return pd.DataFrame(res, columns=fields)
+
+    def _drop_table(self, table):
+        """Discards a table recorded by the C++ backend, returning whether it
+        was recorded.
+        """
+        cdef cpp_cyclus.ColumnarBack* cpp_ptx = \
+            <cpp_cyclus.ColumnarBack*> self.ptx
+        return bool_to_py(cpp_ptx.DropTable(str_py_to_cpp(table)))
+
+    def _clear_tables(self):
+        """Discards all tables recorded by the C++ backend."""
+        (<cpp_cyclus.ColumnarBack*> self.ptx).Clear()
+
     #
     # Condition application
     #
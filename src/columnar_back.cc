@@ -0,0 +1,161 @@
+#include "columnar_back.h"
+
+#include <cstring>
+
+#include <boost/uuid/uuid.hpp>
+
+#include "blob.h"
+#include "datum.h"
+#include "error.h"
+
+namespace cyclus {
+
+ColumnarBack::ColumnarBack() : store_all_tables_(true) {}
+
+void ColumnarBack::Notify(DatumList data) {
+  if (!store_all_tables_ && registry_.empty())
+    return;
+
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    Datum* d = *it;
+    std::string title = d->title();
+    if (!store_all_tables_ && registry_.count(title) == 0)
+      continue;
+
+    const Datum::Vals& vals = d->vals();
+    Table& t = tables_[title];
+    if (t.cols.empty()) {
+      t.cols.resize(vals.size());
+      for (int i = 0; i < vals.size(); ++i)
+        InitColumn(&t.cols[i], vals[i].first, vals[i].second);
+    } else if (vals.size() != t.cols.size()) {
+      throw ValueError("datum of table '" + title + "' does not have the "
+                       "fields of the first datum of the table");
+    }
+
+    for (int i = 0; i < vals.size(); ++i)
+      Append(&t.cols[i], vals[i].second);
+    t.nrows++;
+  }
+}
+
+std::string ColumnarBack::Name() {
+  return "<Columnar In-Memory Backend>";
+}
+
+std::set<std::string> ColumnarBack::Tables() {
+  std::set<std::string> rtn;
+  std::map<std::string, Table>::iterator it;
+  for (it = tables_.begin(); it != tables_.end(); ++it)
+    rtn.insert(it->first);
+  return rtn;
+}
+
+ColumnarBack::Table& ColumnarBack::GetTable(std::string name) {
+  std::map<std::string, Table>::iterator it = tables_.find(name);
+  if (it == tables_.end())
+    throw KeyError("table '" + name + "' has not been recorded");
+  return it->second;
+}
+
+bool ColumnarBack::DropTable(std::string name) {
+  return tables_.erase(name) > 0;
+}
+
+void ColumnarBack::Clear() {
+  tables_.clear();
+}
+
+void ColumnarBack::InitColumn(Column* c, const char* field,
+                              const boost::spirit::hold_any& v) {
+  c->field = field;
+  c->encoded = false;
+  if (v.type() == typeid(int)) {
+    c->format = 'i';
+    c->itemsize = sizeof(int);
+  } else if (v.type() == typeid(int64_t)) {
+    c->format = 'q';
+    c->itemsize = sizeof(int64_t);
+  } else if (v.type() == typeid(double)) {
+    c->format = 'd';
+    c->itemsize = sizeof(double);
+  } else if (v.type() == typeid(float)) {
+    c->format = 'f';
+    c->itemsize = sizeof(float);
+  } else if (v.type() == typeid(bool)) {
+    c->format = '?';
+    c->itemsize = sizeof(bool);
+  } else if (v.type() == typeid(std::string) ||
+             v.type() == typeid(boost::uuids::uuid) ||
+             v.type() == typeid(Blob)) {
+    c->format = 'i';
+    c->itemsize = sizeof(int);
+    c->encoded = true;
+  } else {
+    c->format = 0;
+    c->itemsize = 0;
+  }
+}
+
+void ColumnarBack::Append(Column* c, const boost::spirit::hold_any& v) {
+  if (c->itemsize == 0) {
+    c->values.push_back(v);
+    return;
+  }
+
+  size_t n = c->data.size();
+  c->data.resize(n + c->itemsize);
+  char* dst = &c->data[n];
+  if (!c->encoded) {
+    switch (c->format) {
+      case 'i': {
+        int x = v.cast<int>();
+        std::memcpy(dst, &x, sizeof(int));
+        break;
+      }
+      case 'q': {
+        int64_t x = v.cast<int64_t>();
+        std::memcpy(dst, &x, sizeof(int64_t));
+        break;
+      }
+      case 'd': {
+        double x = v.cast<double>();
+        std::memcpy(dst, &x, sizeof(double));
+        break;
+      }
+      case 'f': {
+        float x = v.cast<float>();
+        std::memcpy(dst, &x, sizeof(float));
+        break;
+      }
+      case '?': {
+        bool x = v.cast<bool>();
+        std::memcpy(dst, &x, sizeof(bool));
+        break;
+      }
+    }
+    return;
+  }
+
+  std::string key;
+  if (v.type() == typeid(std::string)) {
+    key = v.cast<std::string>();
+  } else if (v.type() == typeid(boost::uuids::uuid)) {
+    const boost::uuids::uuid& u = v.cast<boost::uuids::uuid>();
+    key.assign(u.begin(), u.end());
+  } else {
+    key = v.cast<Blob>().str();
+  }
+  std::unordered_map<std::string, int>::iterator it = c->codes.find(key);
+  int code;
+  if (it == c->codes.end()) {
+    code = c->values.size();
+    c->codes[key] = code;
+    c->values.push_back(v);
+  } else {
+    code = it->second;
+  }
+  std::memcpy(dst, &code, sizeof(int));
+}
+
+}  // namespace cyclus
@@ -0,0 +1,123 @@
+#ifndef CYCLUS_SRC_COLUMNAR_BACK_H_
+#define CYCLUS_SRC_COLUMNAR_BACK_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "any.hpp"
+#include "rec_backend.h"
+
+namespace cyclus {
+
+/// An in-memory Recorder backend that accumulates each table as typed column
+/// buffers, rather than as rows of boxed values. It is the storage behind the
+/// Python in-memory backend, which hands the buffers to NumPy without
+/// converting them cell by cell.
+///
+/// Columns holding int, float, double and bool values are stored as
+/// contiguous arrays of that type. Columns holding strings, uuids and blobs
+/// are dictionary encoded: the buffer is an array of int codes into the list
+/// of the distinct values seen. This keeps e.g. the SimId and commodity
+/// columns to a handful of values no matter how many rows are recorded. Any
+/// other type is kept as one hold_any per row.
+class ColumnarBack : public RecBackend {
+ public:
+  /// A single column of a table.
+  struct Column {
+    /// the field name
+    std::string field;
+
+    /// the struct module (and buffer protocol) format character of the
+    /// values in data: 'i', 'q', 'f', 'd' or '?'. Encoded columns have the
+    /// format of their codes, 'i'. Zero if the column has no data buffer.
+    char format;
+
+    /// the size in bytes of a single value in data, zero if the column has no
+    /// data buffer.
+    int itemsize;
+
+    /// true if data holds codes into values instead of the values themselves.
+    bool encoded;
+
+    /// the contiguous buffer of values or codes, one per row.
+    std::vector<char> data;
+
+    /// the distinct values of encoded columns, or every value of columns
+    /// without a data buffer.
+    std::vector<boost::spirit::hold_any> values;
+
+    /// the code of each distinct value of encoded columns, keyed by the
+    /// value's raw bytes.
+    std::unordered_map<std::string, int> codes;
+  };
+
+  /// The columns of a single table, in the order of the fields of its first
+  /// Datum.
+  struct Table {
+    Table() : nrows(0) {}
+    std::vector<Column> cols;
+    int nrows;
+  };
+
+  ColumnarBack();
+
+  virtual ~ColumnarBack() {}
+
+  /// Appends the values of each Datum object to the columns of its table.
+  virtual void Notify(DatumList data);
+
+  virtual std::string Name();
+
+  /// No-op, the data is already in its final location.
+  virtual void Flush() {}
+
+  /// No-op, the stored tables outlive the recorder so that they can still be
+  /// queried. Use Clear to discard them.
+  virtual void Close() {}
+
+  /// Returns the names of the stored tables.
+  std::set<std::string> Tables();
+
+  /// Returns the stored table with the given name.
+  ///
+  /// @throws KeyError if the table has not been stored.
+  Table& GetTable(std::string name);
+
+  /// Discards the table with the given name, returning whether it was stored.
+  bool DropTable(std::string name);
+
+  /// Discards all stored tables.
+  void Clear();
+
+  /// Returns whether all tables are stored, or only those in the registry.
+  bool store_all_tables() { return store_all_tables_; }
+
+  /// Sets whether all tables are stored, or only those in the registry.
+  void store_all_tables(bool x) { store_all_tables_ = x; }
+
+  /// Returns the names of the tables stored when not storing all tables.
+  const std::set<std::string>& registry() { return registry_; }
+
+  /// Sets the names of the tables stored when not storing all tables. Tables
+  /// that were already stored are kept.
+  void registry(const std::set<std::string>& r) { registry_ = r; }
+
+ private:
+  /// Sets up the column for values of the type of v.
+  static void InitColumn(Column* c, const char* field,
+                         const boost::spirit::hold_any& v);
+
+  /// Appends v to the column c.
+  static void Append(Column* c, const boost::spirit::hold_any& v);
+
+  std::map<std::string, Table> tables_;
+  bool store_all_tables_;
+  std::set<std::string> registry_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_COLUMNAR_BACK_H_
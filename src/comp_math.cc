@@ -1,12 +1,18 @@
 #include "comp_math.h"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
+#include <vector>
 
 #include "cyc_arithmetic.h"
 #include "error.h"
 #include "pyne.h"
 
+extern "C" {
+#include "transmute.h"
+}
+
 // Undefines isnan from pyne
 #ifdef isnan
   #undef isnan
@@ -15,6 +21,34 @@
 namespace cyclus {
 namespace compmath {
 
+namespace {
+
+/// Nuclide data indexed by the transmute nuclide index (see
+/// cyclus_transmute_nucid_to_i).
+struct NucTable {
+  NucTable()
+      : mass(cyclus_transmute_info.n),
+        lambda(cyclus_transmute_info.n) {
+    for (int i = 0; i < cyclus_transmute_info.n; ++i) {
+      int nuc = cyclus_transmute_info.nucids[i];
+      mass[i] = pyne::atomic_mass(nuc);
+      lambda[i] = pyne::decay_const(nuc);
+    }
+  }
+
+  std::vector<double> mass;
+  std::vector<double> lambda;
+};
+
+/// The table is built on first use rather than at load time, because pyne's
+/// nuclear data path is only set once the environment is initialized.
+const NucTable& Table() {
+  static const NucTable t;
+  return t;
+}
+
+}  // namespace
+
 CompMap Add(const CompMap& v1, const CompMap& v2) {
   CompMap out(v1);
   for (CompMap::const_iterator it = v2.begin(); it != v2.end(); ++it) {
@@ -133,5 +167,101 @@ bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold) {
   return true;
 }
 
+double AtomicMass(Nuc nuc) {
+  int i = cyclus_transmute_nucid_to_i(nuc);
+  if (i < 0) {
+    return pyne::atomic_mass(nuc);
+  }
+  return Table().mass[i];
+}
+
+double DecayConst(Nuc nuc) {
+  int i = cyclus_transmute_nucid_to_i(nuc);
+  if (i < 0) {
+    return pyne::decay_const(nuc);
+  }
+  return Table().lambda[i];
+}
+
+void MassToAtom(const CompMap& mass, CompMap* atom) {
+  const NucTable& t = Table();
+  // keys arrive in order, so filling an empty map takes linear time
+  CompMap::iterator hint = atom->begin();
+  CompMap::const_iterator it;
+  for (it = mass.begin(); it != mass.end(); ++it) {
+    int i = cyclus_transmute_nucid_to_i(it->first);
+    double m = i < 0 ? pyne::atomic_mass(it->first) : t.mass[i];
+    hint = atom->insert(hint, std::make_pair(it->first, 0.0));
+    hint->second += it->second / m;
+    ++hint;
+  }
+}
+
+void AtomToMass(const CompMap& atom, CompMap* mass) {
+  const NucTable& t = Table();
+  // keys arrive in order, so filling an empty map takes linear time
+  CompMap::iterator hint = mass->begin();
+  CompMap::const_iterator it;
+  for (it = atom.begin(); it != atom.end(); ++it) {
+    int i = cyclus_transmute_nucid_to_i(it->first);
+    double m = i < 0 ? pyne::atomic_mass(it->first) : t.mass[i];
+    hint = mass->insert(hint, std::make_pair(it->first, 0.0));
+    hint->second += it->second * m;
+    ++hint;
+  }
+}
+
+double MaxDecayConst(const CompMap& v) {
+  const NucTable& t = Table();
+  double max = 0;
+  CompMap::const_iterator it;
+  for (it = v.begin(); it != v.end(); ++it) {
+    int i = cyclus_transmute_nucid_to_i(it->first);
+    double lambda = i < 0 ? pyne::decay_const(it->first) : t.lambda[i];
+    max = std::max(max, lambda);
+  }
+  return max;
+}
+
+MassSum::MassSum()
+    : dense_(cyclus_transmute_info.n, 0.0),
+      used_(cyclus_transmute_info.n, false) {}
+
+void MassSum::Add(const CompMap& mass, double qty) {
+  double sum = Sum(mass);
+  double mult = (sum != 0 && sum != qty) ? qty / sum : 1;
+  CompMap::const_iterator it;
+  for (it = mass.begin(); it != mass.end(); ++it) {
+    int i = cyclus_transmute_nucid_to_i(it->first);
+    if (i < 0) {
+      other_[it->first] += it->second * mult;
+      continue;
+    }
+    if (!used_[i]) {
+      used_[i] = true;
+      touched_.push_back(i);
+    }
+    dense_[i] += it->second * mult;
+  }
+}
+
+void MassSum::Take(CompMap* out) {
+  out->clear();
+  out->swap(other_);
+
+  // the nuclide ids of the decay matrix are sorted, so are the indices
+  std::sort(touched_.begin(), touched_.end());
+  CompMap::iterator hint = out->begin();
+  for (int j = 0; j < touched_.size(); ++j) {
+    int i = touched_[j];
+    hint = out->insert(hint, std::make_pair(cyclus_transmute_info.nucids[i],
+                                            dense_[i]));
+    ++hint;
+    dense_[i] = 0;
+    used_[i] = false;
+  }
+  touched_.clear();
+}
+
 }  // namespace compmath
 }  // namespace cyclus
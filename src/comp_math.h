@@ -1,6 +1,8 @@
 #ifndef CYCLUS_SRC_COMP_MATH_H_
 #define CYCLUS_SRC_COMP_MATH_H_
 
+#include <vector>
+
 #include "composition.h"
 
 namespace cyclus {
@@ -49,6 +51,57 @@ bool AllPositive(const CompMap& v);
 /// normalization is performed.
 bool AlmostEq(const CompMap& v1, const CompMap& v2, double threshold);
 
+/// Returns the atomic mass of nuc in amu, the same value as
+/// pyne::atomic_mass. Nuclides in the decay matrix are looked up in a dense
+/// table that is built from pyne on first use.
+double AtomicMass(Nuc nuc);
+
+/// Returns the decay constant of nuc in 1/s, the same value as
+/// pyne::decay_const. Uses the same table as AtomicMass.
+double DecayConst(Nuc nuc);
+
+/// Adds the atom quantities of the nuclides in mass to atom.
+void MassToAtom(const CompMap& mass, CompMap* atom);
+
+/// Adds the mass quantities of the nuclides in atom to mass.
+void AtomToMass(const CompMap& atom, CompMap* mass);
+
+/// Returns the largest decay constant (1/s) of the nuclides in v, or zero if
+/// all of them are stable.
+double MaxDecayConst(const CompMap& v);
+
+/// Sums mass compositions into a dense buffer indexed by the transmute
+/// nuclide index, without creating any intermediate maps or compositions.
+/// The buffer is kept between sums, so one MassSum can be reused to
+/// aggregate many inventories. Example:
+///
+/// @code
+/// compmath::MassSum sum;
+/// sum.Add(m1->comp()->mass(), m1->quantity());
+/// sum.Add(m2->comp()->mass(), m2->quantity());
+/// CompMap total;  // nuclide masses in kg
+/// sum.Take(&total);
+/// @endcode
+class MassSum {
+ public:
+  MassSum();
+
+  /// Adds the mass composition mass, normalized to qty.
+  void Add(const CompMap& mass, double qty);
+
+  /// Stores the summed masses in out, replacing its contents, and clears the
+  /// sum.
+  void Take(CompMap* out);
+
+ private:
+  std::vector<double> dense_;
+  std::vector<bool> used_;
+  std::vector<int> touched_;
+
+  /// nuclides that are not in the decay matrix.
+  CompMap other_;
+};
+
 }  // namespace compmath
 }  // namespace cyclus
 
@@ -1,9 +1,14 @@
 #include "composition.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 #include "comp_math.h"
 #include "context.h"
 #include "decayer.h"
 #include "error.h"
+#include "pool_alloc.h"
 #include "recorder.h"
 
 extern "C" {
@@ -12,7 +17,21 @@ extern "C" {
 
 namespace cyclus {
 
-int Composition::next_id_ = 1;
+/// Compositions are allocated from a pool, together with the reference counts
+/// of their shared pointer.
+class Composition::Pooled : public Composition {
+ public:
+  template <typename... Args>
+  Pooled(Args&&... args) : Composition(std::forward<Args>(args)...) {}
+};
+
+int64_t Composition::next_id_ = 1;
+int Composition::record_epoch_ = 0;
+
+Composition::DecayStats& Composition::decay_stats() {
+  static DecayStats s;
+  return s;
+}
 
 Composition::Ptr Composition::CreateFromAtom(CompMap v) {
   if (!compmath::ValidNucs(v))
@@ -21,7 +40,7 @@ Composition::Ptr Composition::CreateFromAtom(CompMap v) {
   if (!compmath::AllPositive(v))
     throw ValueError("negative quantity in CompMap");
 
-  Composition::Ptr c(new Composition());
+  Composition::Ptr c = PoolNew<Composition, Pooled>();
   c->atom_ = v;
   return c;
 }
@@ -33,43 +52,38 @@ Composition::Ptr Composition::CreateFromMass(CompMap v) {
   if (!compmath::AllPositive(v))
     throw ValueError("negative quantity in CompMap");
 
-  Composition::Ptr c(new Composition());
+  Composition::Ptr c = PoolNew<Composition, Pooled>();
   c->mass_ = v;
   return c;
 }
 
-int Composition::id() {
+int64_t Composition::id() {
   return id_;
 }
 
 const CompMap& Composition::atom() {
   if (atom_.size() == 0) {
-    CompMap::iterator it;
-    for (it = mass_.begin(); it != mass_.end(); ++it) {
-      Nuc nuc = it->first;
-      atom_[nuc] = it->second / pyne::atomic_mass(nuc);
-    }
+    compmath::MassToAtom(mass_, &atom_);
   }
   return atom_;
 }
 
 const CompMap& Composition::mass() {
   if (mass_.size() == 0) {
-    CompMap::iterator it;
-    for (it = atom_.begin(); it != atom_.end(); ++it) {
-      Nuc nuc = it->first;
-      mass_[nuc] = it->second * pyne::atomic_mass(nuc);
-    }
+    compmath::AtomToMass(atom_, &mass_);
   }
   return mass_;
 }
 
 Composition::Ptr Composition::Decay(int delta, uint64_t secs_per_timestep) {
   int tot_decay = prev_decay_ + delta;
-  if (decay_line_->count(tot_decay) == 1) {
+  Chain::iterator it = decay_line_->find(tot_decay);
+  if (it != decay_line_->end()) {
     // decay_line_ has cached, pre-computed result of this decay
-    return (*decay_line_)[tot_decay];
+    decay_stats().hits++;
+    return it->second;
   }
+  decay_stats().misses++;
 
   // Calculate a new decayed composition and insert it into the decay chain.
   // It will automagically appear in the decay chain for all other compositions
@@ -84,11 +98,129 @@ Composition::Ptr Composition::Decay(int delta) {
   return Decay(delta, kDefaultTimeStepDur);
 }
 
+std::vector<Composition::Ptr> Composition::Decay(
+    const std::vector<Ptr>& cs, const std::vector<int>& deltas,
+    uint64_t secs_per_timestep) {
+  std::vector<Ptr> decayed(cs.size());
+
+  // Collect the decays that are not cached in their chain yet, once each.
+  // Everything that touches shared state (lazy atom evaluation, id
+  // assignment, the decay chains) happens on this thread.
+  std::vector<Composition*> parents;
+  std::vector<int> parent_deltas;
+  std::vector<int> job(cs.size(), -1);
+  std::map<std::pair<Chain*, int>, int> jobs;
+  for (int i = 0; i < cs.size(); ++i) {
+    Composition* c = cs[i].get();
+    int tot_decay = c->prev_decay_ + deltas[i];
+    Chain::iterator it = c->decay_line_->find(tot_decay);
+    if (it != c->decay_line_->end()) {
+      decayed[i] = it->second;
+      decay_stats().hits++;
+      continue;
+    }
+
+    std::pair<Chain*, int> key(c->decay_line_.get(), tot_decay);
+    std::map<std::pair<Chain*, int>, int>::iterator jt = jobs.find(key);
+    if (jt != jobs.end()) {
+      job[i] = jt->second;
+      decay_stats().hits++;
+      continue;
+    }
+    decay_stats().misses++;
+    c->atom();
+    job[i] = parents.size();
+    jobs[key] = parents.size();
+    parents.push_back(c);
+    parent_deltas.push_back(deltas[i]);
+  }
+
+  int n = parents.size();
+  std::vector<CompMap> atoms(n);
+  #pragma omp parallel for if (n > 1) schedule(dynamic)
+  for (int j = 0; j < n; ++j) {
+    if (parents[j]->atom_.size() > 0) {
+      atoms[j] = DecayAtoms(parents[j]->atom_, parent_deltas[j],
+                            secs_per_timestep);
+    }
+  }
+
+  // create the compositions in job order, so that ids do not depend on how
+  // the calculations were scheduled.
+  std::vector<Ptr> created(n);
+  for (int j = 0; j < n; ++j) {
+    Composition* c = parents[j];
+    int tot_decay = c->prev_decay_ + parent_deltas[j];
+    created[j] = PoolNew<Composition, Pooled>(tot_decay, c->decay_line_);
+    created[j]->atom_.swap(atoms[j]);
+    (*c->decay_line_)[tot_decay] = created[j];
+  }
+  for (int i = 0; i < cs.size(); ++i) {
+    if (job[i] >= 0) {
+      decayed[i] = created[job[i]];
+    }
+  }
+  return decayed;
+}
+
+Composition::Ptr Composition::FindDecay(int delta) {
+  Chain::iterator it = decay_line_->find(prev_decay_ + delta);
+  if (it == decay_line_->end()) {
+    return Ptr();
+  }
+  return it->second;
+}
+
+CompMap Composition::DecayMass(int delta, uint64_t secs_per_timestep) {
+  CompMap mass;
+  if (atom_.size() > 0) {
+    compmath::AtomToMass(DecayAtoms(atom_, delta, secs_per_timestep), &mass);
+  }
+  return mass;
+}
+
+/// The fraction by which a nuclide with the decay constant lambda (1/time
+/// step) changes in dt time steps.
+static double DecayChange(double lambda, int dt) {
+  return 1.0 - std::exp(-lambda * static_cast<double>(dt));
+}
+
+int Composition::DecayThreshold(uint64_t secs_per_timestep, double eps) {
+  if (threshold_secs_ == secs_per_timestep && threshold_eps_ == eps) {
+    return threshold_dt_;
+  }
+
+  double lambda = compmath::MaxDecayConst(atom()) *
+                  static_cast<double>(secs_per_timestep);
+  int dt = INT_MAX;
+  double guess = INT_MAX;
+  if (lambda > 0) {
+    guess = std::ceil(-std::log1p(-eps) / lambda);
+  }
+  if (guess < INT_MAX) {
+    // the guess can be off by one due to rounding, so settle it with the
+    // same expression the change is tested with.
+    dt = std::max(1, static_cast<int>(guess));
+    while (dt > 1 && DecayChange(lambda, dt - 1) >= eps) {
+      --dt;
+    }
+    while (dt < INT_MAX && DecayChange(lambda, dt) < eps) {
+      ++dt;
+    }
+  }
+
+  threshold_secs_ = secs_per_timestep;
+  threshold_eps_ = eps;
+  threshold_dt_ = dt;
+  return dt;
+}
+
 void Composition::Record(Context* ctx) {
-  if (recorded_) {
+  if (recorded_ && epoch_ == record_epoch_) {
     return;
   }
   recorded_ = true;
+  epoch_ = record_epoch_;
 
   CompMap::const_iterator it;
   CompMap cm = mass();  // force lazy evaluation now
@@ -102,7 +234,11 @@ void Composition::Record(Context* ctx) {
   }
 }
 
-Composition::Composition() : prev_decay_(0), recorded_(false) {
+Composition::Composition()
+    : prev_decay_(0),
+      recorded_(false),
+      epoch_(record_epoch_),
+      threshold_secs_(0) {
   id_ = next_id_;
   next_id_++;
   decay_line_ = ChainPtr(new Chain());
@@ -110,8 +246,10 @@ Composition::Composition() : prev_decay_(0), recorded_(false) {
 
 Composition::Composition(int prev_decay, ChainPtr decay_line)
     : recorded_(false),
+      epoch_(record_epoch_),
       prev_decay_(prev_decay),
-      decay_line_(decay_line) {
+      decay_line_(decay_line),
+      threshold_secs_(0) {
   id_ = next_id_;
   next_id_++;
 }
@@ -122,17 +260,24 @@ Composition::Ptr Composition::NewDecay(int delta, uint64_t secs_per_timestep) {
 
   // the new composition is a part of this decay chain and so is created with a
   // pointer to the exact same decay_line_.
-  Composition::Ptr decayed(new Composition(tot_decay, decay_line_));
+  Composition::Ptr decayed =
+      PoolNew<Composition, Pooled>(tot_decay, decay_line_);
 
   // FIXME this is only here for testing, see issue #761
   if (atom_.size() == 0)
     return decayed;
 
+  decayed->atom_ = DecayAtoms(atom_, delta, secs_per_timestep);
+  return decayed;
+}
+
+CompMap Composition::DecayAtoms(const CompMap& atom, int delta,
+                                uint64_t secs_per_timestep) {
   // Get intial condition vector
   std::vector<double> n0 (cyclus_transmute_info.n, 0.0);
   CompMap::const_iterator it;
   int i = -1;
-  for (it = atom_.begin(); it != atom_.end(); ++it) {
+  for (it = atom.begin(); it != atom.end(); ++it) {
     i = cyclus_transmute_nucid_to_i(it->first);
     if (i < 0) {
       continue;
@@ -158,8 +303,7 @@ Composition::Ptr Composition::NewDecay(int delta, uint64_t secs_per_timestep) {
       cm[(cyclus_transmute_info.nucids)[i]] = n1[i];
     }
   }
-  decayed->atom_ = cm;
-  return decayed;
+  return cm;
 }
 
 }  // namespace cyclus
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <stdint.h>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 class SimInitTest;
@@ -42,6 +43,20 @@ class Composition {
  public:
   typedef boost::shared_ptr<Composition> Ptr;
 
+  /// Counts how decays were answered since the counters were last reset.
+  struct DecayStats {
+    DecayStats() : hits(0), misses(0) {}
+
+    /// decays found in the decay chain.
+    int64_t hits;
+
+    /// decays that had to be calculated.
+    int64_t misses;
+  };
+
+  /// Returns the decay counters of all compositions.
+  static DecayStats& decay_stats();
+
   /// Creates a new composition from v with its components having appropriate
   /// atom-based ratios. v does not need to be normalized to any particular
   /// value.
@@ -56,7 +71,7 @@ class Composition {
   /// material objects can share the same composition. Also Note that the id is
   /// not the same for two compositions that were separately created from the
   /// same CompMap.
-  int id();
+  int64_t id();
 
   /// Returns the unnormalized atom composition.
   const CompMap& atom();
@@ -73,6 +88,33 @@ class Composition {
   /// delta timesteps) using the seconds to timestep conversion specified.
   Ptr Decay(int delta, uint64_t secs_per_timestep);
 
+  /// Returns decayed versions of the compositions cs (cs[i] decayed deltas[i]
+  /// timesteps), the same as calling Decay on each of them. Each distinct
+  /// decay that is not in a decay chain yet is calculated only once, and
+  /// these calculations are spread across threads if OpenMP is available.
+  static std::vector<Ptr> Decay(const std::vector<Ptr>& cs,
+                                const std::vector<int>& deltas,
+                                uint64_t secs_per_timestep);
+
+  /// Returns the decayed version of this composition (decayed delta
+  /// timesteps) if it is already in the decay chain, or a null pointer. The
+  /// decay chain and the decay counters are left unchanged.
+  Ptr FindDecay(int delta);
+
+  /// Returns the unnormalized mass composition that decaying this
+  /// composition delta timesteps results in, without creating a composition
+  /// or adding it to the decay chain. Once atom() and mass() have been
+  /// evaluated, this only reads shared data, so it is safe to call from
+  /// several threads at once.
+  CompMap DecayMass(int delta, uint64_t secs_per_timestep);
+
+  /// Returns the smallest number of time steps after which the number density
+  /// of at least one nuclide changes by a fraction of eps or more, i.e. the
+  /// smallest dt with 1 - exp(-lambda*dt) >= eps. Returns INT_MAX if all
+  /// nuclides are stable. The result is cached for the last time step
+  /// duration and eps asked for.
+  int DecayThreshold(uint64_t secs_per_timestep, double eps);
+
   /// Records the composition in output database Compositions table (if
   /// not done previously).
   void Record(Context* ctx);
@@ -97,14 +139,34 @@ class Composition {
   /// Performs a decay calculation and creates a new decayed composition.
   Ptr NewDecay(int delta, uint64_t secs_per_timestep);
 
-  static int next_id_;
-  int id_;
+  /// Returns the atom composition that results from decaying atom delta
+  /// timesteps. Only reads shared data, so it is safe to call from several
+  /// threads at once.
+  static CompMap DecayAtoms(const CompMap& atom, int delta,
+                            uint64_t secs_per_timestep);
+
+  static int64_t next_id_;
+  int64_t id_;
   bool recorded_;
+
+  /// Compositions recorded before the current record epoch are recorded
+  /// again. SimInit starts a new epoch for the output of a forked branch.
+  static int record_epoch_;
+  int epoch_;
   CompMap atom_;
   CompMap mass_;
 
   /// the total time delta this composition has been decayed from its root ancestor.
   int prev_decay_;
+
+  /// the cached result of DecayThreshold and the arguments it was computed
+  /// for. threshold_secs_ is zero if nothing is cached.
+  uint64_t threshold_secs_;
+  double threshold_eps_;
+  int threshold_dt_;
+
+  /// the pool allocated type of all compositions (see PoolNew).
+  class Pooled;
 };
 
 }  // namespace cyclus
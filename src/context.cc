@@ -7,6 +7,7 @@
 #include "exchange_solver.h"
 #include "logger.h"
 #include "pyhooks.h"
+#include "res_lineage.h"
 #include "sim_init.h"
 #include "timer.h"
 #include "version.h"
@@ -22,9 +23,15 @@ SimInfo::SimInfo()
       m0(0),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      decay_interval(1),
       branch_time(-1),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      compact_provenance(false),
+      delta_snapshots(false),
+      checkpoint_interval(0),
+      checkpoint_wall(0),
+      checkpoint_backoff(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -34,10 +41,16 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle)
       m0(m0),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      decay_interval(1),
       branch_time(-1),
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      compact_provenance(false),
+      delta_snapshots(false),
+      checkpoint_interval(0),
+      checkpoint_wall(0),
+      checkpoint_backoff(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -47,10 +60,16 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle, std::string d)
       m0(m0),
       dt(kDefaultTimeStepDur),
       decay(d),
+      decay_interval(1),
       branch_time(-1),
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      compact_provenance(false),
+      delta_snapshots(false),
+      checkpoint_interval(0),
+      checkpoint_wall(0),
+      checkpoint_backoff(0),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -62,21 +81,33 @@ SimInfo::SimInfo(int dur, boost::uuids::uuid parent_sim,
       m0(-1),
       dt(kDefaultTimeStepDur),
       decay("manual"),
+      decay_interval(1),
       parent_sim(parent_sim),
       parent_type(parent_type),
       branch_time(branch_time),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      compact_provenance(false),
+      delta_snapshots(false),
+      checkpoint_interval(0),
+      checkpoint_wall(0),
+      checkpoint_backoff(0),
       handle(handle) {}
 
 Context::Context(Timer* ti, Recorder* rec)
     : ti_(ti),
       rec_(rec),
       solver_(NULL),
+      lineage_(NULL),
       trans_id_(0),
       si_(0) {}
 
 Context::~Context() {
+  if (lineage_ != NULL) {
+    lineage_->Flush();
+    delete lineage_;
+  }
+
   if (solver_ != NULL) {
     delete solver_;
   }
@@ -200,11 +231,29 @@ void Context::InitSim(SimInfo si) {
       ->AddVal("Decay", si.decay)
       ->Record();
 
+  NewDatum("DecayInterval")
+      ->AddVal("Interval", si.decay_interval)
+      ->Record();
+
   NewDatum("InfoExplicitInv")
       ->AddVal("RecordInventory", si.explicit_inventory)
       ->AddVal("RecordInventoryCompact", si.explicit_inventory_compact)
       ->Record();
 
+  NewDatum("ProvenanceMode")
+      ->AddVal("Compact", si.compact_provenance)
+      ->Record();
+
+  NewDatum("SnapshotMode")
+      ->AddVal("Delta", si.delta_snapshots)
+      ->Record();
+
+  NewDatum("CheckpointPolicy")
+      ->AddVal("Interval", si.checkpoint_interval)
+      ->AddVal("WallSecs", si.checkpoint_wall)
+      ->AddVal("BackoffSecs", si.checkpoint_backoff)
+      ->Record();
+
   // TODO: when the backends get uint64_t support, the static_cast here should
   // be removed.
   NewDatum("TimeStepDur")
@@ -221,6 +270,9 @@ void Context::InitSim(SimInfo si) {
       ->Record();
 
   si_ = si;
+  if (si.compact_provenance && lineage_ == NULL) {
+    lineage_ = new ResLineage(this);
+  }
   ti_->Initialize(this, si);
 }
 
@@ -237,7 +289,7 @@ void Context::UnregisterTimeListener(TimeListener* tl) {
 }
 
 Datum* Context::NewDatum(std::string title) {
-  return rec_->NewDatum(title);
+  return rec_->NewDatum(title, time());
 }
 
 void Context::Snapshot() {
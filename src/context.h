@@ -28,6 +28,7 @@ namespace cyclus {
 class Datum;
 class ExchangeSolver;
 class Recorder;
+class ResLineage;
 class Trader;
 class Timer;
 class TimeListener;
@@ -77,6 +78,14 @@ class SimInfo {
   /// "manual" if use of the decay function is allowed, "never" otherwise
   std::string decay;
 
+  /// In "lazy" decay mode, materials are only decayed by whole multiples of
+  /// this many time steps, so that materials with a common composition share
+  /// decayed compositions instead of each being decayed to a slightly
+  /// different time. A decayed composition thus lags the current time by
+  /// less than decay_interval time steps. 1 (the default) decays materials
+  /// exactly up to the current time.
+  int decay_interval;
+
   /// length of the simulation in timesteps (months)
   int duration;
 
@@ -113,6 +122,31 @@ class SimInfo {
   /// every time step in a table (i.e. agent ID, Time, Quantity,
   /// Composition-object and/or reference).
   bool explicit_inventory_compact;
+
+  /// True if resource provenance should be compacted, so that resource states
+  /// superseded within a time step are not recorded (see ResLineage).
+  bool compact_provenance;
+
+  /// True if snapshots should only record the agents whose state or
+  /// inventories changed since the previous snapshot (see SimInit::Snapshot).
+  /// This shrinks the output, but every agent is still serialized and hashed
+  /// at each snapshot.
+  bool delta_snapshots;
+
+  /// Number of time steps between automatic checkpoint snapshots, or 0 for
+  /// none.
+  int checkpoint_interval;
+
+  /// Wall-clock seconds between automatic checkpoint snapshots, or 0 for
+  /// none.
+  double checkpoint_wall;
+
+  /// Wall-clock seconds after which a checkpoint counts as slow, or 0 to
+  /// never back off. A checkpoint cannot be cut short, but after a slow one
+  /// the checkpoint intervals are stretched by how much it took longer, which
+  /// bounds the share of the run time spent checkpointing rather than the
+  /// pause of any single checkpoint.
+  double checkpoint_backoff;
 };
 
 /// A simulation context provides access to necessary simulation-global
@@ -241,9 +275,17 @@ class Context {
     return si_;
   }
 
-  /// See Recorder::NewDatum documentation.
+  /// See Recorder::NewDatum documentation. The datum is created at the
+  /// current time step, so tables filtered out by the recording policy are
+  /// discarded here before any values are added.
   Datum* NewDatum(std::string title);
 
+  /// Returns the collector of the current time step's resource states if
+  /// provenance is compacted, NULL otherwise.
+  inline ResLineage* lineage() {
+    return lineage_;
+  }
+
   /// Schedules a snapshot of simulation state to output database to occur at
   /// the beginning of the next timestep.
   void Snapshot();
@@ -310,7 +352,12 @@ class Context {
   Timer* ti_;
   ExchangeSolver* solver_;
   Recorder* rec_;
+  ResLineage* lineage_;
   int trans_id_;
+
+  /// digests of the agents' state as of their last recorded snapshot, by
+  /// agent id. Only used for delta snapshots.
+  std::map<int, Digest> snap_digests_;
 };
 
 }  // namespace cyclus
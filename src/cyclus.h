@@ -28,6 +28,7 @@
 #include "pyne.h"
 #include "query_backend.h"
 #include "infile_tree.h"
+#include "json_infile_tree.h"
 #include "recorder.h"
 #include "region.h"
 #include "request.h"
@@ -11,6 +11,8 @@ typedef boost::singleton_pool<Datum, sizeof(Datum)> DatumPool;
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Datum* Datum::AddValBase(const char* field, boost::spirit::hold_any val,
                          std::vector<int>* shape) {
+  if (discard_)
+    return this;
   vals_.push_back(std::pair<const char*, boost::spirit::hold_any>(field, val));
   std::vector<int> s;
   if (shape == NULL)
@@ -22,23 +24,30 @@ Datum* Datum::AddValBase(const char* field, boost::spirit::hold_any val,
 
 Datum* Datum::AddVal(const char* field, boost::spirit::hold_any val,
                      std::vector<int>* shape) {
+  if (discard_)
+    return this;
   fields_.push_back(std::string(field));
   return AddValBase(field, val, shape);
 }
 
 Datum* Datum::AddVal(std::string field, boost::spirit::hold_any val,
                      std::vector<int>* shape) {
+  if (discard_)
+    return this;
   fields_.push_back(field);
   return AddValBase(field.c_str(), val, shape);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Datum::Record() {
+  if (discard_)
+    return;
   manager_->AddDatum(this);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Datum::Datum(Recorder* m, std::string title) : title_(title), manager_(m) {
+Datum::Datum(Recorder* m, std::string title)
+    : title_(title), manager_(m), discard_(false) {
   // The (vect) size to reserve is chosen to be just bigger than most/all cyclus
   // core tables.  This prevents extra reallocations in the underlying
   // vector as vals are added to the datum.
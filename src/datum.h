@@ -81,6 +81,10 @@ class Datum {
 
   Recorder* manager_;
   std::string title_;
+
+  /// true for the Recorder's datum of filtered tables, whose values are
+  /// never stored nor recorded.
+  bool discard_;
   Vals vals_;
   Shapes shapes_;
   Fields fields_;
@@ -15,6 +15,7 @@
 #include "dynamic_module.h"
 #include "env.h"
 #include "recorder.h"
+#include "startup_profile.h"
 #include "suffix.h"
 #include "timer.h"
 
@@ -49,6 +50,7 @@ std::set<std::string> DiscoverSpecs(std::string p, std::string lib) {
   using std::string;
   using std::set;
   namespace fs = boost::filesystem;
+  ProfileScope prof("DiscoverSpecs " + p + ":" + lib);
   // find file
   string libpath = (fs::path(p) / fs::path("lib" + lib + SUFFIX)).string();
   libpath = Env::FindModule(libpath);
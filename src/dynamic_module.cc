@@ -8,6 +8,7 @@
 #include "env.h"
 #include "agent.h"
 #include "pyhooks.h"
+#include "startup_profile.h"
 #include "suffix.h"
 
 #include DYNAMICLOADLIB
@@ -76,6 +77,7 @@ Agent* DynamicModule::Make(Context* ctx, AgentSpec spec) {
     a->spec(spec.str());
     return a;
   } else if (modules_.count(spec.str()) == 0) {
+    ProfileScope prof("DynamicModule " + spec.str());
     DynamicModule* dyn = new DynamicModule(spec);
     modules_[spec.str()] = dyn;
   }
@@ -136,4 +138,17 @@ std::string DynamicModule::path() {
   return path_;
 }
 
+std::string DynamicModule::LibraryFile(AgentSpec spec) {
+  std::map<std::string, DynamicModule*>::iterator it;
+  it = modules_.find(spec.str());
+  if (man_ctors_.count(spec.str()) > 0 || it == modules_.end()) {
+    return "";
+  }
+  std::string p = it->second->path();
+  if (boost::starts_with(p, "<py>")) {
+    p = p.substr(4);
+  }
+  return p;
+}
+
 }  // namespace cyclus
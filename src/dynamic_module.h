@@ -74,6 +74,11 @@ class DynamicModule {
   /// The path to the module's shared object library.
   std::string path();
 
+  /// Returns the shared object library or Python module file that the agents
+  /// of spec were made from, or an empty string if none has been loaded for
+  /// spec.
+  static std::string LibraryFile(AgentSpec spec);
+
  private:
   /// Creates a new dynamically loadable module.
   /// @param name the name of the module
@@ -79,6 +79,11 @@ class Env {
   /// CYCLUS_PATH
   static const std::vector<std::string> cyclus_path();
 
+  /// @return the directory of the compiled input cache given by the
+  /// CYCLUS_INPUT_CACHE environment variable, or an empty string if input
+  /// caching is disabled.
+  static const std::string input_cache();
+
   /// @return whether or not Cyclus should allow Mixed-Integer Linear Programs
   /// The default depends on a compile time option DEFAULT_ALLOW_MILPS, but
   /// may be specified at run time with the ALLOW_MILPS environment variable
@@ -36,6 +36,7 @@ class ExchangeSolver {
   inline void verbose() { verbose_ = true; }
   inline void graph(ExchangeGraph* graph) { graph_ = graph; }
   inline ExchangeGraph* graph() const { return graph_; }
+  inline bool exclusive_orders() const { return exclusive_orders_; }
 
   /// @brief interface for solving a given exchange graph
   /// @param a pointer to the graph to be solved
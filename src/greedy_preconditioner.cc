@@ -29,7 +29,8 @@ GreedyPreconditioner::GreedyPreconditioner() {};
 
 GreedyPreconditioner::GreedyPreconditioner(
     const std::map<std::string, double>& commod_weights)
-    : commod_weights_(commod_weights) {
+    : commod_priority_(commod_weights),
+      commod_weights_(commod_weights) {
   if (commod_weights_.size() != 0)
     ProcessWeights_(END);
 };
@@ -37,7 +38,8 @@ GreedyPreconditioner::GreedyPreconditioner(
 GreedyPreconditioner::GreedyPreconditioner(
     const std::map<std::string, double>& commod_weights,
     WgtOrder order)
-    : commod_weights_(commod_weights) {
+    : commod_priority_(commod_weights),
+      commod_weights_(commod_weights) {
   if (commod_weights_.size() != 0)
     ProcessWeights_(order);
 };
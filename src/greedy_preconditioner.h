@@ -58,6 +58,7 @@ double AvgPref(ExchangeNode::Ptr n);
 /// Finally, the groups themselves will be ordered by average weight:
 ///   #. {g2, g1}
 class GreedyPreconditioner {
+  friend class SimInit;
  public:
   /// @brief the order of commodity weights
   enum WgtOrder {
@@ -105,6 +106,8 @@ class GreedyPreconditioner {
 
   bool apply_commod_weights_;
   std::map<ExchangeNode::Ptr, double> avg_prefs_;
+  /// the commodity weights as given, before processing
+  std::map<std::string, double> commod_priority_;
   std::map<std::string, double> commod_weights_;
   std::map<RequestGroup::Ptr, double> group_weights_;
 };
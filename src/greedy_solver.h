@@ -61,6 +61,7 @@ class GreedyPreconditioner;
 ///
 /// @warning the GreedySolver is responsible for deleting is conditioner!
 class GreedySolver: public ExchangeSolver {
+  friend class SimInit;
  public:
   /// GreedySolver constructor
   /// @param exclusive_orders a flag for enforcing integral, quantized orders
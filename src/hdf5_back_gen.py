@@ -1,9 +1,9 @@
 #!/usr/bin/env python
 """This module generates HDF5 backend code found in src/hdf5_back.cc
 
-There are 8 distinct code generation options, one of which must be passed 
+There are 9 distinct code generation options, one of which must be passed 
 as an argument to this module. They are CREATE, QUERY, VL_DATASET, 
-FILL_BUF, WRITE, VAL_TO_BUF_H, VAL_TO_BUF, and BUF_TO_VAL. Each of these 
+ENCODER, VL_HASH, WRITE, VAL_TO_BUF_H, VAL_TO_BUF, and BUF_TO_VAL. Each of these 
 generates a different section of Hdf5 backend code. All are invoked by 
 src/CMakeLists.txt prior to C++ compilation. However, for debugging purposes, 
 each section can be printed individually by passing that section's identifier 
@@ -996,6 +996,7 @@ def list_body(t, depth=0, prefix="", base_offset="buf+offset"):
     return node
 
 BODIES = {"INT": reinterpret_cast_body,
+          "LONG": reinterpret_cast_body,
           "DOUBLE": reinterpret_cast_body,
           "FLOAT": reinterpret_cast_body,
           "BOOL": reinterpret_cast_body,
@@ -1289,6 +1290,7 @@ def get_variation_body(t):
     return body
 
 HDF5_PRIMITIVES = {"INT": "H5T_NATIVE_INT",
+                   "LONG": "H5T_NATIVE_INT64",
                    "DOUBLE": "H5T_NATIVE_DOUBLE",
                    "FLOAT": "H5T_NATIVE_FLOAT",
                    "BOOL": "H5T_NATIVE_CHAR",
@@ -1297,6 +1299,7 @@ HDF5_PRIMITIVES = {"INT": "H5T_NATIVE_INT",
                    "UUID": "uuid_type_"}
 
 PRIMITIVE_SIZES = {"INT": "sizeof(int)",
+                   "LONG": "sizeof(int64_t)",
                    "DOUBLE": "sizeof(double)",
                    "FLOAT": "sizeof(float)",
                    "BOOL": "sizeof(char)",
@@ -1729,22 +1732,39 @@ def main_vl_dataset():
     output = indent(output, INDENT*2)
     return output
 
-def main_fill_buf():
-    """HDF5 FILL_BUF: Generates the FillBuf function code."""
+def main_vl_hash():
+    """HDF5 VL_HASH: Generates the HashVLVal function code.
+
+    Only types which are entirely variable length are hashed as-is when they
+    are written. Others are first truncated to the column shape, and so must
+    still be hashed in WriteToBuf.
+    """
+    CPPGEN = CppGen()
+    output = ""
+    for i in CANON_TYPES:
+        node = CANON_TO_NODE[i]
+        if not DB_TO_VL[node.db] or not is_all_vl(node):
+            continue
+        update = FuncCall(name=Raw(code="hasher->Update"),
+                          args=[Raw(code="a->cast<" + node.cpp + ">()")])
+        case_body = ExprStmt(child=update)
+        output += CPPGEN.visit(case_template(node, case_body))
+    output = indent(output, INDENT*2)
+    return output
+
+def main_encoder():
+    """HDF5 ENCODER: Generates the EncoderFor function code, which maps each
+    database type to its WriteToBuf specialization."""
     CPPGEN = CppGen()
     output = ""
     for i in CANON_TYPES:
         node = CANON_TO_NODE[i]
-        write_to_buf = FuncCall(name=Var(name="WriteToBuf"), 
-                                targs=[Raw(code=node.db)],
-                                args=[Raw(code="buf+offset"), 
-                                      Raw(code="shapes[col]"),
-                                      Raw(code="a"), Raw(code="sizes[col]")])
-        case_body = ExprStmt(child=write_to_buf)
+        ret = Raw(code="return &Hdf5Back::WriteToBuf<" + node.db + ">")
+        case_body = ExprStmt(child=ret)
         output += CPPGEN.visit(case_template(node, case_body))
-    output = indent(output, INDENT*4)
+    output = indent(output, INDENT*2)
     return output
-                    
+
 vl_write_vl_string = """hasher_.Clear();
 hasher_.Update({var});
 Digest {key} = hasher_.digest();
@@ -1768,8 +1788,25 @@ if (vlkeys_[{t.db}].count({key}) != 1) {{
 VL_SPECIAL_TYPES = {"VL_STRING": vl_write_vl_string,
                     "BLOB": vl_write_blob}
 
-def vl_write(t, variable, depth=0, prefix="", pointer=False):
-    """HDF5 Write: Return code previously found in VLWrite."""
+vl_write_hash = """hasher_.Clear();
+hasher_.Update({var});
+Digest {key} = hasher_.digest();\n"""
+
+vl_write_prehashed = """Digest {key};
+if (vldigest_ != NULL) {{
+  {key} = *vldigest_;
+}} else {{
+  hasher_.Clear();
+  hasher_.Update({var});
+  {key} = hasher_.digest();
+}}\n"""
+
+def vl_write(t, variable, depth=0, prefix="", pointer=False, prehashed=False):
+    """HDF5 Write: Return code previously found in VLWrite.
+
+    If prehashed is True, the digest computed up front by FillBuf (vldigest_)
+    is used when it is available rather than hashing the value again.
+    """
     buf_variable = get_variable("buf", depth=depth, prefix=prefix)
     key_variable = get_variable("key", depth=depth, prefix=prefix)
     keysds_variable = get_variable("keysds", depth=depth, prefix=prefix)
@@ -1790,6 +1827,8 @@ if (vlkeys_[{t.db}].count({key}) != 1) {{
   AppendVLKey({keysds}, {t.db}, {key});
   InsertVLVal({valsds}, {t.db}, {key}, {buf});
 }}\n"""
+    if prehashed:
+        node_str = node_str.replace(vl_write_hash, vl_write_prehashed, 1)
     node = Raw(code=node_str.format(var=variable, no_p_var=variable.strip("*"), 
                                     key=key_variable,
                                     keysds=keysds_variable, t=t,  
@@ -2195,7 +2234,7 @@ def get_write_body(t, shape_array, depth=0, prefix="", variable="a",
     # If entirely variable length, we can simply use the VLWrite definition
     if all_vl:
         result.nodes.append(vl_write(t, variable, depth=depth, prefix=prefix, 
-                                     pointer=pointer))
+                                     pointer=pointer, prehashed=(depth == 0)))
         key = get_variable("key", depth=depth, prefix=prefix)
         result.nodes.append(memcpy(offset, key + ".val", "CYCLUS_SHA1_SIZE"))
         return result
@@ -2331,7 +2370,7 @@ def main_write():
                        name=Var(name="Hdf5Back::WriteToBuf"),
                        targs=[Raw(code=t.db)], 
                        args=[Decl(type=Type(cpp="char*"), name=Var(name="buf")),
-                             Decl(type=Type(cpp="std::vector<int>&"), 
+                             Decl(type=Type(cpp="const std::vector<int>&"), 
                                   name=Var(name="shape")),
                              Decl(type=Type(
                                           cpp="const boost::spirit::hold_any*"),
@@ -2836,7 +2875,8 @@ def setup():
     MAIN_DISPATCH = {"QUERY": main_query,
                      "CREATE": main_create,
                      "VL_DATASET": main_vl_dataset,
-                     "FILL_BUF": main_fill_buf,
+                     "ENCODER": main_encoder,
+                     "VL_HASH": main_vl_hash,
                      "WRITE": main_write,
                      "VAL_TO_BUF_H": main_val_to_buf_h,
                      "VAL_TO_BUF": main_val_to_buf,
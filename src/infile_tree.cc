@@ -1,6 +1,10 @@
 // Implements class for querying XML snippets
+#include <ctype.h>
+
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 #include <libxml++/libxml++.h>
 #include <boost/lexical_cast.hpp>
@@ -10,6 +14,60 @@
 
 namespace cyclus {
 
+/// The child elements of the visited elements by name. Elements that have
+/// namespaced children are not indexed, because a plain name does not
+/// match those in XPath.
+struct InfileTree::Index {
+  typedef std::map<std::string, std::vector<xmlpp::Node*> > Children;
+
+  /// Returns the children of node by name, or NULL if node cannot be indexed.
+  Children* Get(xmlpp::Node* node) {
+    std::unordered_map<xmlpp::Node*, Children>::iterator it;
+    it = elems.find(node);
+    if (it != elems.end()) {
+      return &it->second;
+    } else if (unindexed.count(node) > 0) {
+      return NULL;
+    }
+
+    Children c;
+    const xmlpp::Node::NodeList nodelist = node->get_children();
+    xmlpp::Node::NodeList::const_iterator child;
+    for (child = nodelist.begin(); child != nodelist.end(); ++child) {
+      xmlpp::Element* element = dynamic_cast<xmlpp::Element*>(*child);
+      if (!element) {
+        continue;
+      } else if (element->get_namespace_uri() != "") {
+        unindexed.insert(node);
+        return NULL;
+      }
+      c[element->get_name()].push_back(element);
+    }
+    return &(elems[node] = c);
+  }
+
+  std::unordered_map<xmlpp::Node*, Children> elems;
+  std::set<xmlpp::Node*> unindexed;
+};
+
+/// Returns true if query is a relative path of plain element names.
+static bool SimplePath(const std::string& query) {
+  if (query.empty() || query[0] == '/' || query[query.size() - 1] == '/') {
+    return false;
+  }
+  for (int i = 0; i < query.size(); ++i) {
+    char c = query[i];
+    if (c == '/') {
+      if (query[i - 1] == '/') {
+        return false;
+      }
+    } else if (!isalnum(c) && c != '_' && c != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 InfileTree::InfileTree(XMLParser& parser) : current_node_(0) {
   current_node_ = parser.Document()->get_root_node();
@@ -45,9 +103,38 @@ int InfileTree::NElements() {
   return n;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<xmlpp::Node*> InfileTree::Find(const std::string& query) {
+  if (!SimplePath(query)) {
+    return current_node_->find(query);
+  }
+
+  if (!index_) {
+    index_.reset(new Index());
+  }
+  std::vector<std::string> names;
+  boost::split(names, query, boost::is_any_of("/"));
+  std::vector<xmlpp::Node*> nodes(1, current_node_);
+  for (int i = 0; i < names.size(); ++i) {
+    std::vector<xmlpp::Node*> next;
+    for (int j = 0; j < nodes.size(); ++j) {
+      Index::Children* c = index_->Get(nodes[j]);
+      if (c == NULL) {
+        return current_node_->find(query);
+      }
+      Index::Children::iterator it = c->find(names[i]);
+      if (it != c->end()) {
+        next.insert(next.end(), it->second.begin(), it->second.end());
+      }
+    }
+    nodes.swap(next);
+  }
+  return nodes;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int InfileTree::NMatches(std::string query) {
-  return current_node_->find(query).size();
+  return Find(query).size();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -56,7 +143,7 @@ std::string InfileTree::GetString(std::string query, int index) {
   using xmlpp::NodeSet;
   using xmlpp::TextNode;
   using xmlpp::Element;
-  const NodeSet nodeset = current_node_->find(query);
+  const NodeSet nodeset = Find(query);
   if (nodeset.empty()) {
     throw KeyError("Could not find a node by the name: " + query);
   }
@@ -113,7 +200,7 @@ std::string InfileTree::GetElementName(int index) {
 InfileTree* InfileTree::GetEngineFromQuery(std::string query, int index) {
   using xmlpp::Node;
   using xmlpp::NodeSet;
-  const NodeSet nodeset = current_node_->find(query);
+  const NodeSet nodeset = Find(query);
 
   if (nodeset.size() < index + 1) {
     throw ValueError("Index exceeds number of nodes in query: " + query);
@@ -126,7 +213,9 @@ InfileTree* InfileTree::GetEngineFromQuery(std::string query, int index) {
                     " is not an Element node.");
   }
 
-  return new InfileTree(element);
+  InfileTree* child = new InfileTree(element);
+  child->index_ = index_;
+  return child;
 }
 
 InfileTree* InfileTree::SubTree(std::string query, int index) {
@@ -136,4 +225,10 @@ InfileTree* InfileTree::SubTree(std::string query, int index) {
   return qe_child;
 }
 
+void InfileTree::ReleaseSubTree(InfileTree* child) {
+  if (spawned_children_.erase(child) > 0) {
+    delete child;
+  }
+}
+
 }  // namespace cyclus
@@ -7,6 +7,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "xml_parser.h"
 
@@ -19,6 +20,11 @@ namespace cyclus {
 /// @class InfileTree
 ///
 /// A class for extracting information from a given XML parser
+///
+/// Simple path queries made only of element names (e.g. "a" or "a/b/val")
+/// are answered from an index of the child elements by name, which is built
+/// once per element and shared by all subtrees. Any other query is
+/// evaluated as an XPath expression.
 class InfileTree {
  public:
   /// constructor given a parser
@@ -53,6 +59,11 @@ class InfileTree {
   /// @return a initialized infile based on the query and index
   InfileTree* SubTree(std::string query, int index = 0);
 
+  /// deletes a child infile returned by SubTree before this infile is
+  /// destroyed, along with any infiles spawned from it
+  /// @param child the child infile, which must not be used afterwards
+  void ReleaseSubTree(InfileTree* child);
+
  protected:
   /// constructor given a node
   /// @param node the node to set as the current node
@@ -70,8 +81,15 @@ class InfileTree {
   void SetCurrentNode(xmlpp::Node* node);
 
  private:
+  struct Index;
+
+  /// Returns the nodes matching query relative to the current node, in
+  /// document order.
+  std::vector<xmlpp::Node*> Find(const std::string& query);
+
   std::set<InfileTree*> spawned_children_;
   xmlpp::Node* current_node_;
+  boost::shared_ptr<Index> index_;
 };
 
 /// @brief a query method for required parameters
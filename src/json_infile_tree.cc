@@ -0,0 +1,185 @@
+// Implements class for querying JSON input files
+#include "json_infile_tree.h"
+
+#include <ctype.h>
+
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include "error.h"
+#include "pyne.h"
+
+namespace cyclus {
+
+/// Returns true if name is "*" or a plain element name.
+static bool ValidName(const std::string& name) {
+  if (name == "*") {
+    return true;
+  } else if (name.empty()) {
+    return false;
+  }
+  for (int i = 0; i < name.size(); ++i) {
+    char c = name[i];
+    if (!isalnum(c) && c != '_' && c != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+JsonInfileTree::JsonInfileTree(const std::string& json)
+    : InfileTree(static_cast<xmlpp::Node*>(NULL)),
+      doc_(new Json::Value()) {
+  Json::Reader reader;
+  if (!reader.parse(json, *doc_, false)) {
+    throw ValidationError("Failed to parse JSON input:\n" +
+                          reader.getFormattedErrorMessages());
+  }
+
+  // like an xml document, the input must have a single root element
+  std::vector<Elem> roots;
+  Children(Elem(doc_.get(), ""), "*", &roots);
+  if (roots.size() != 1) {
+    throw ValidationError("JSON input must have a single root element");
+  }
+  current_ = roots[0];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+JsonInfileTree::JsonInfileTree(boost::shared_ptr<Json::Value> doc,
+                               const Elem& current)
+    : InfileTree(static_cast<xmlpp::Node*>(NULL)),
+      doc_(doc),
+      current_(current) {}
+
+JsonInfileTree::~JsonInfileTree() {}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JsonInfileTree::Expand(const Json::Value& v, const std::string& name,
+                            std::vector<Elem>* out) {
+  if (!v.isArray() || v.size() == 0) {
+    out->push_back(Elem(&v, name));
+    return;
+  }
+  for (int i = 0; i < v.size(); ++i) {
+    Expand(v[i], name, out);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JsonInfileTree::Children(const Elem& e, const std::string& name,
+                              std::vector<Elem>* out) {
+  const Json::Value& v = *e.val;
+  if (!v.isObject()) {
+    return;
+  } else if (name != "*") {
+    if (v.isMember(name)) {
+      Expand(v[name], name, out);
+    }
+    return;
+  }
+
+  std::vector<std::string> keys = v.getMemberNames();
+  for (int i = 0; i < keys.size(); ++i) {
+    Expand(v[keys[i]], keys[i], out);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::vector<JsonInfileTree::Elem> JsonInfileTree::Find(
+    const std::string& query) {
+  std::vector<Elem> elems;
+  if (query == ".") {
+    elems.push_back(current_);
+    return elems;
+  }
+
+  std::vector<std::string> names;
+  if (!query.empty() && query[0] == '/') {
+    elems.push_back(Elem(doc_.get(), ""));
+    boost::split(names, query.substr(1), boost::is_any_of("/"));
+  } else {
+    elems.push_back(current_);
+    boost::split(names, query, boost::is_any_of("/"));
+  }
+
+  for (int i = 0; i < names.size(); ++i) {
+    if (!ValidName(names[i])) {
+      throw ValueError("Unsupported query on a JSON input: " + query);
+    }
+    std::vector<Elem> next;
+    for (int j = 0; j < elems.size(); ++j) {
+      Children(elems[j], names[i], &next);
+    }
+    elems.swap(next);
+  }
+  return elems;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int JsonInfileTree::NElements() {
+  std::vector<Elem> elems;
+  Children(current_, "*", &elems);
+  return elems.size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int JsonInfileTree::NMatches(std::string query) {
+  return Find(query).size();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string JsonInfileTree::GetString(std::string query, int index) {
+  std::vector<Elem> elems = Find(query);
+  if (elems.empty()) {
+    throw KeyError("Could not find a node by the name: " + query);
+  }
+
+  if (elems.size() < index + 1) {
+    throw ValueError("Index exceeds number of nodes in query: " + query);
+  }
+
+  // scalars are written the same way as by toolkit::JsonToXml
+  const Elem& e = elems[index];
+  const Json::Value& v = *e.val;
+  std::stringstream ss;
+  if (v.isString() && v.asString() != "") {
+    ss << v.asString();
+  } else if (v.isInt()) {
+    ss << v.asInt64();
+  } else if (v.isUInt()) {
+    ss << v.asUInt64();
+  } else if (v.isDouble()) {
+    ss << v.asDouble();
+  } else if (v.isBool()) {
+    ss << v.asBool();
+  } else {
+    throw ValueError("Element node " + e.name +
+                     " has more content than expected.");
+  }
+  return ss.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::string JsonInfileTree::GetElementName(int index) {
+  std::vector<Elem> elems;
+  Children(current_, "*", &elems);
+  if (elems.size() < index + 1) {
+    throw ValueError("Index exceeds number of elements in node: "
+                     + current_.name);
+  }
+  return elems[index].name;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InfileTree* JsonInfileTree::GetEngineFromQuery(std::string query, int index) {
+  std::vector<Elem> elems = Find(query);
+  if (elems.size() < index + 1) {
+    throw ValueError("Index exceeds number of nodes in query: " + query);
+  }
+  return new JsonInfileTree(doc_, elems[index]);
+}
+
+}  // namespace cyclus
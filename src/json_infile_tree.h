@@ -0,0 +1,82 @@
+#ifndef CYCLUS_SRC_JSON_INFILE_TREE_H_
+#define CYCLUS_SRC_JSON_INFILE_TREE_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "infile_tree.h"
+
+namespace Json {
+  class Value;
+}
+
+namespace cyclus {
+
+/// @class JsonInfileTree
+///
+/// An InfileTree that answers queries directly from a parsed JSON input,
+/// without converting it to XML first. The JSON document is seen through the
+/// same element structure that toolkit::JsonToXml produces: object members
+/// are elements named by their key (in key order), the items of an array are
+/// repeated elements named by the key of the array, nulls are empty elements
+/// and scalars are the text of their element.
+///
+/// Only the path queries used by the input loaders and archetypes are
+/// supported: relative or absolute paths of element names, where a name may
+/// be "*" (any element) and the whole query may be "." (the current
+/// element). Any other query throws a ValueError.
+class JsonInfileTree : public InfileTree {
+ public:
+  /// constructor given a JSON document
+  /// @param json the JSON text of the input file
+  /// @throw ValidationError if the text is not valid JSON
+  JsonInfileTree(const std::string& json);
+
+  virtual ~JsonInfileTree();
+
+  virtual int NElements();
+
+  virtual std::string GetElementName(int index = 0);
+
+  virtual int NMatches(std::string query);
+
+  virtual std::string GetString(std::string query, int index = 0);
+
+ protected:
+  virtual InfileTree* GetEngineFromQuery(std::string query, int index);
+
+ private:
+  /// An element of the JSON document.
+  struct Elem {
+    Elem() : val(NULL) {}
+    Elem(const Json::Value* v, const std::string& n) : val(v), name(n) {}
+
+    const Json::Value* val;
+    std::string name;
+  };
+
+  JsonInfileTree(boost::shared_ptr<Json::Value> doc, const Elem& current);
+
+  /// Appends the elements for the value v of the member name. Like
+  /// toolkit::JsonToXml, nested arrays are flattened and an empty array is a
+  /// single empty element.
+  static void Expand(const Json::Value& v, const std::string& name,
+                     std::vector<Elem>* out);
+
+  /// Appends the child elements of e named name (or all of them for "*").
+  static void Children(const Elem& e, const std::string& name,
+                       std::vector<Elem>* out);
+
+  /// Returns the elements matching query relative to the current element, in
+  /// document order.
+  std::vector<Elem> Find(const std::string& query);
+
+  boost::shared_ptr<Json::Value> doc_;
+  Elem current_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_JSON_INFILE_TREE_H_
@@ -1,33 +1,45 @@
 #include "material.h"
 
 #include <math.h>
+#include <map>
 
 #include "comp_math.h"
 #include "context.h"
 #include "decayer.h"
 #include "error.h"
 #include "logger.h"
+#include "pool_alloc.h"
 
 namespace cyclus {
 
 const ResourceType Material::kType = "Material";
 
+/// Materials are allocated from a pool, together with the reference counts of
+/// their shared pointer.
+class Material::Pooled : public Material {
+ public:
+  template <typename... Args>
+  Pooled(Args&&... args) : Material(std::forward<Args>(args)...) {}
+};
+
 Material::~Material() {}
 
 Material::Ptr Material::Create(Agent* creator, double quantity,
                                Composition::Ptr c) {
-  Material::Ptr m(new Material(creator->context(), quantity, c));
+  Material::Ptr m =
+      PoolNew<Material, Pooled>(creator->context(), quantity, c);
   m->tracker_.Create(creator);
   return m;
 }
 
 Material::Ptr Material::CreateUntracked(double quantity,
                                         Composition::Ptr c) {
-  Material::Ptr m(new Material(NULL, quantity, c));
+  Material::Ptr m = PoolNew<Material, Pooled>(
+      static_cast<Context*>(NULL), quantity, c);
   return m;
 }
 
-int Material::qual_id() const {
+int64_t Material::qual_id() const {
   return comp_->id();
 }
 
@@ -36,10 +48,9 @@ const ResourceType Material::type() const {
 }
 
 Resource::Ptr Material::Clone() const {
-  Material* m = new Material(*this);
-  Resource::Ptr c(m);
+  Material::Ptr m = PoolNew<Material, Pooled>(*this);
   m->tracker_.DontTrack();
-  return c;
+  return m;
 }
 
 void Material::Record(Context* ctx) const {
@@ -88,7 +99,7 @@ Material::Ptr Material::ExtractComp(double qty, Composition::Ptr c,
 
   qty_ -= qty;
 
-  Material::Ptr other(new Material(ctx_, qty, c));
+  Material::Ptr other = PoolNew<Material, Pooled>(ctx_, qty, c);
 
   // Decay called on the extracted material should have the same dt as for
   // this material regardless of composition.
@@ -125,6 +136,48 @@ void Material::Absorb(Material::Ptr mat) {
   tracker_.Absorb(&mat->tracker_);
 }
 
+void Material::Absorb(const std::vector<Material::Ptr>& mats) {
+  if (mats.empty()) {
+    return;
+  }
+
+  // these calls force lazy evaluation if in lazy decay mode
+  Composition::Ptr c0 = comp();
+  bool same = true;
+  for (int i = 0; i < mats.size(); ++i) {
+    same = same && mats[i]->comp() == c0;
+  }
+
+  if (!same) {
+    CompMap v(c0->mass());
+    compmath::Normalize(&v, qty_);
+    for (int i = 0; i < mats.size(); ++i) {
+      CompMap otherv(mats[i]->comp_->mass());
+      compmath::Normalize(&otherv, mats[i]->qty_);
+      CompMap::iterator it;
+      for (it = otherv.begin(); it != otherv.end(); ++it) {
+        v[it->first] += it->second;
+      }
+    }
+    comp_ = Composition::CreateFromMass(v);
+  }
+
+  // see Absorb(Ptr) for how the decay time is chosen.
+  std::vector<ResTracker*> trackers;
+  for (int i = 0; i < mats.size(); ++i) {
+    if (qty_ < mats[i]->qty_) {
+      prev_decay_time_ = mats[i]->prev_decay_time_;
+    }
+    qty_ += mats[i]->qty_;
+    trackers.push_back(&mats[i]->tracker_);
+  }
+
+  tracker_.Absorb(trackers);
+  for (int i = 0; i < mats.size(); ++i) {
+    mats[i]->qty_ = 0;
+  }
+}
+
 void Material::Transmute(Composition::Ptr c) {
   comp_ = c;
   tracker_.Modify();
@@ -142,55 +195,95 @@ void Material::Transmute(Composition::Ptr c) {
 }
 
 void Material::Decay(int curr_time) {
-  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+  uint64_t secs_per_timestep;
+  int dt = DecayDelta(&curr_time, &secs_per_timestep);
+  if (dt == 0) {
     return;
-  } else if (curr_time < 0 && ctx_ == NULL) {
+  }
+
+  prev_decay_time_ = curr_time; // this must go before Transmute call
+  Composition::Ptr decayed = comp_->Decay(dt, secs_per_timestep);
+  Transmute(decayed);
+}
+
+void Material::Decay(const std::vector<Material::Ptr>& mats, int curr_time) {
+  // group the materials that need a decay by their time step duration
+  std::map<uint64_t, std::vector<int> > groups;
+  std::vector<int> times(mats.size());
+  std::vector<int> dts(mats.size());
+  for (int i = 0; i < mats.size(); ++i) {
+    uint64_t secs_per_timestep;
+    times[i] = curr_time;
+    dts[i] = mats[i]->DecayDelta(&times[i], &secs_per_timestep);
+    if (dts[i] != 0) {
+      groups[secs_per_timestep].push_back(i);
+    }
+  }
+
+  std::map<uint64_t, std::vector<int> >::iterator it;
+  for (it = groups.begin(); it != groups.end(); ++it) {
+    const std::vector<int>& idx = it->second;
+    std::vector<Composition::Ptr> comps(idx.size());
+    std::vector<int> deltas(idx.size());
+    for (int j = 0; j < idx.size(); ++j) {
+      comps[j] = mats[idx[j]]->comp_;
+      deltas[j] = dts[idx[j]];
+    }
+
+    std::vector<Composition::Ptr> decayed =
+        Composition::Decay(comps, deltas, it->first);
+    for (int j = 0; j < idx.size(); ++j) {
+      Material* m = mats[idx[j]].get();
+      m->prev_decay_time_ = times[idx[j]];  // this must go before Transmute
+      m->Transmute(decayed[j]);
+    }
+  }
+}
+
+int Material::DecayDelta(int* curr_time, uint64_t* secs_per_timestep) {
+  if (ctx_ != NULL && ctx_->sim_info().decay == "never") {
+    return 0;
+  } else if (*curr_time < 0 && ctx_ == NULL) {
     throw ValueError("decay cannot use default time with NULL context");
   }
 
-  if (curr_time < 0) {
-    curr_time = ctx_->time();
+  if (*curr_time < 0) {
+    *curr_time = ctx_->time();
   }
 
-  int dt = curr_time - prev_decay_time_;
+  int dt = *curr_time - prev_decay_time_;
+  int interval = 1;
+  if (ctx_ != NULL && ctx_->sim_info().decay == "lazy") {
+    interval = ctx_->sim_info().decay_interval;
+  }
+  if (interval > 1 && dt > 0) {
+    // only decay by whole intervals, the rest is carried over.
+    dt -= dt % interval;
+    *curr_time = prev_decay_time_ + dt;
+  }
   if (dt == 0) {
-    return;
+    return 0;
   }
 
   double eps = 1e-3;
-  const CompMap c = comp_->atom();
 
   // If composition has too many nuclides (i.e. > 100), it is cheaper to
   // just do the decay rather than check all the decay constants.
-  bool decay = c.size() > 100;
+  bool decay = comp_->atom().size() > 100;
 
-  uint64_t secs_per_timestep = kDefaultTimeStepDur;
+  *secs_per_timestep = kDefaultTimeStepDur;
   if (ctx_ != NULL) {
-    secs_per_timestep = ctx_->sim_info().dt;
-  }
-
-  if (!decay) {
-    // Only do the decay calc if one of the nuclides would change in number
-    // density more than fraction eps.
-    // i.e. decay if   (1 - eps) > exp(-lambda*dt)
-    CompMap::const_reverse_iterator it;
-    for (it = c.rbegin(); it != c.rend(); ++it) {
-      int nuc = it->first;
-      double lambda_timesteps = pyne::decay_const(nuc) * static_cast<double>(secs_per_timestep);
-      double change = 1.0 - std::exp(-lambda_timesteps * static_cast<double>(dt));
-      if (change >= eps) {
-        decay = true;
-        break;
-      }
-    }
-    if (!decay) {
-      return;
-    }
+    *secs_per_timestep = ctx_->sim_info().dt;
   }
 
-  prev_decay_time_ = curr_time; // this must go before Transmute call
-  Composition::Ptr decayed = comp_->Decay(dt, secs_per_timestep);
-  Transmute(decayed);
+  // Only do the decay calc if one of the nuclides would change in number
+  // density more than fraction eps.
+  // i.e. decay if   (1 - eps) > exp(-lambda*dt)
+  // The composition caches the smallest such dt.
+  if (!decay && dt < comp_->DecayThreshold(*secs_per_timestep, eps)) {
+    return 0;
+  }
+  return dt;
 }
 
 double Material::DecayHeat() {
@@ -216,6 +309,16 @@ Composition::Ptr Material::comp() {
   return comp_;
 }
 
+Composition::Ptr Material::PeekComp(int* delta) {
+  *delta = 0;
+  if (ctx_ != NULL && ctx_->sim_info().decay == "lazy") {
+    int curr_time = -1;
+    uint64_t secs_per_timestep;
+    *delta = DecayDelta(&curr_time, &secs_per_timestep);
+  }
+  return comp_;
+}
+
 Material::Material(Context* ctx, double quantity, Composition::Ptr c)
     : qty_(quantity),
       comp_(c),
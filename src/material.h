@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_MATERIAL_H_
 
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "composition.h"
@@ -88,7 +89,7 @@ class Material: public Resource {
   static Ptr CreateUntracked(double quantity, Composition::Ptr c);
 
   /// Returns the id of the material's internal nuclide composition.
-  virtual int qual_id() const;
+  virtual int64_t qual_id() const;
 
   /// Returns Material::kType.
   virtual const ResourceType type() const;
@@ -123,6 +124,12 @@ class Material: public Resource {
   /// Combines material mat with this one.  mat's quantity becomes zero.
   void Absorb(Ptr mat);
 
+  /// Combines all materials in mats with this one in a single pass.  The
+  /// constituent masses are accumulated once and a single new composition is
+  /// created for the result.  The result is the same as absorbing each
+  /// material in turn, and each material's quantity becomes zero.
+  void Absorb(const std::vector<Ptr>& mats);
+
   /// Changes the material's composition to c without changing its mass.  Use
   /// this method for things like converting fresh to spent fuel via burning in
   /// a reactor.
@@ -138,6 +145,14 @@ class Material: public Resource {
   /// constants are significant with respect to the time delta.
   void Decay(int curr_time);
 
+  /// Decays all materials in mats up to curr_time, with the same result as
+  /// calling Decay(curr_time) on each of them. A negative curr_time decays
+  /// each material up to its context's current time. Materials that share a
+  /// composition and time delta are decayed with a single calculation, and
+  /// the distinct calculations run in parallel if OpenMP is available (see
+  /// Composition::Decay).
+  static void Decay(const std::vector<Ptr>& mats, int curr_time = -1);
+
   /// Returns the last time step on which a decay calculation was performed
   /// for the material.  This is not necessarily synonymous with the last time
   /// step the material's Decay function was called.
@@ -153,15 +168,33 @@ class Material: public Resource {
   /// DEPRECATED - use non-const comp() function.
   Composition::Ptr comp() const;
 
+  /// Returns the nuclide composition of the material without changing it,
+  /// and sets delta to the number of time steps comp() would first decay it
+  /// by. delta is only nonzero in lazy decay mode. No composition is created
+  /// and no new resource state is recorded.
+  Composition::Ptr PeekComp(int* delta);
+
  protected:
   Material(Context* ctx, double quantity, Composition::Ptr c);
 
  private:
+  /// Returns the number of time steps the material needs to be decayed by to
+  /// bring it up to curr_time, or zero if no decay calculation is needed. A
+  /// negative curr_time is replaced by the current simulation time, and
+  /// secs_per_timestep is set to the time step duration to decay with. In
+  /// lazy decay mode with a decay interval (see SimInfo::decay_interval), the
+  /// delta is rounded down to whole intervals and curr_time is moved back
+  /// accordingly.
+  int DecayDelta(int* curr_time, uint64_t* secs_per_timestep);
+
   Context* ctx_;
   double qty_;
   Composition::Ptr comp_;
   int prev_decay_time_;
   ResTracker tracker_;
+
+  /// the pool allocated type of all materials (see PoolNew).
+  class Pooled;
 };
 
 /// Creates and returns a new material with the specified quantity and a
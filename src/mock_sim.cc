@@ -211,11 +211,11 @@ int MockSim::Run() {
   return id;
 }
 
-Material::Ptr MockSim::GetMaterial(int resid) {
+Material::Ptr MockSim::GetMaterial(int64_t resid) {
   return SimInit::BuildMaterial(back_, resid);
 }
 
-Product::Ptr MockSim::GetProduct(int resid) {
+Product::Ptr MockSim::GetProduct(int64_t resid) {
   return SimInit::BuildProduct(back_, resid);
 }
 
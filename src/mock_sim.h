@@ -119,7 +119,7 @@ class MockAgent {
 /// EXPECT_EQ(10, n_trans) << "expected 10 transactions, got " << n_trans;
 ///
 /// // reconstruct the material object for the first transaction
-/// int res_id = qr.GetVal<int>("ResourceId", 0);
+/// int64_t res_id = qr.GetVal<int64_t>("ResourceId", 0);
 /// cyclus::Material::Ptr m = sim.GetMaterial(res_id);
 /// EXPECT_DOUBLE_EQ(10, m->quantity());
 ///
@@ -208,11 +208,11 @@ class MockSim {
 
   /// Reconstructs a material object from the simulation results database with
   /// the given resource state id.
-  Material::Ptr GetMaterial(int resid);
+  Material::Ptr GetMaterial(int64_t resid);
 
   /// Reconstructs a product object from the simulation results database with
   /// the given resource state id.
-  Product::Ptr GetProduct(int resid);
+  Product::Ptr GetProduct(int64_t resid);
 
   /// Returns the underlying in-memory database containing results for
   /// the simulation.  Run must be called before the database will contain
@@ -0,0 +1,239 @@
+#include "partition_back.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/string_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "datum.h"
+#include "error.h"
+#include "hdf5_back.h"
+#include "logger.h"
+#include "sqlite_back.h"
+
+namespace fs = boost::filesystem;
+
+namespace cyclus {
+
+const char* PartitionBack::kCatalogName = "catalog.sqlite";
+
+PartitionBack::PartitionBack(std::string path, std::string ext)
+    : path_(path),
+      ext_(ext),
+      catalog_((fs::path(path) / kCatalogName).string()),
+      closed_(false) {
+  if (ext_ != ".sqlite" && ext_ != ".h5")
+    throw ValueError("invalid partition extension '" + ext_ + "', must be "
+                     "'.sqlite' or '.h5'");
+  if (!fs::exists(path_))
+    fs::create_directories(path_);
+  else if (!fs::is_directory(path_))
+    throw IOError("partitioned store path '" + path_ + "' is not a directory");
+
+  catalog_.open();
+  // many processes may register their partitions at once, wait on the
+  // catalog's lock rather than failing.
+  catalog_.Execute("PRAGMA busy_timeout=60000;");
+  catalog_.Execute("CREATE TABLE IF NOT EXISTS Partitions "
+                   "(SimId TEXT PRIMARY KEY, File TEXT, "
+                   "Closed INTEGER DEFAULT 0);");
+}
+
+PartitionBack::~PartitionBack() {
+  try {
+    Close();
+  } catch (Error err) {
+    CLOG(LEV_ERROR) << "Error in PartitionBack destructor: " << err.what();
+  }
+}
+
+void PartitionBack::Notify(DatumList data) {
+  std::map<boost::uuids::uuid, DatumList> groups;
+  for (DatumList::iterator it = data.begin(); it != data.end(); ++it) {
+    const Datum::Vals& vals = (*it)->vals();
+    if (vals.empty() || std::string(vals[0].first) != "SimId")
+      throw ValueError("datum '" + (*it)->title() + "' has no SimId, which "
+                       "is required to record to a partitioned store");
+    groups[vals[0].second.cast<boost::uuids::uuid>()].push_back(*it);
+  }
+
+  std::map<boost::uuids::uuid, DatumList>::iterator it;
+  for (it = groups.begin(); it != groups.end(); ++it)
+    Partition(it->first)->Notify(it->second);
+}
+
+bool PartitionBack::IsStore(std::string path) {
+  if (path.empty())
+    return false;
+  char last = path[path.size() - 1];
+  return last == '/' || last == '\\' || fs::is_directory(path);
+}
+
+std::string PartitionBack::Name() {
+  return path_;
+}
+
+void PartitionBack::Flush() {
+  std::map<boost::uuids::uuid, FullBackend*>::iterator it;
+  for (it = writing_.begin(); it != writing_.end(); ++it)
+    it->second->Flush();
+}
+
+void PartitionBack::Close() {
+  if (closed_)
+    return;
+  closed_ = true;
+  Flush();
+  std::map<std::string, FullBackend*>::iterator it;
+  for (it = parts_.begin(); it != parts_.end(); ++it) {
+    it->second->Close();
+    delete it->second;
+  }
+  parts_.clear();
+
+  // only now may other processes open the written partitions
+  std::map<boost::uuids::uuid, FullBackend*>::iterator w;
+  for (w = writing_.begin(); w != writing_.end(); ++w) {
+    std::string sid = boost::uuids::to_string(w->first);
+    SqlStatement::Ptr stmt = catalog_.Prepare(
+        "UPDATE Partitions SET Closed = 1 WHERE SimId = ?;");
+    stmt->BindText(1, sid.c_str());
+    stmt->Exec();
+  }
+  writing_.clear();
+  catalog_.close();
+}
+
+QueryResult PartitionBack::Query(std::string table, std::vector<Cond>* conds) {
+  // push SimId equality conditions down to the catalog
+  std::set<boost::uuids::uuid> simids;
+  if (conds != NULL) {
+    for (int i = 0; i < conds->size(); ++i) {
+      Cond& c = (*conds)[i];
+      if (c.field == "SimId" && c.opcode == EQ)
+        simids.insert(c.val.cast<boost::uuids::uuid>());
+    }
+  }
+
+  QueryResult qr;
+  std::map<boost::uuids::uuid, std::string> cat =
+      Catalog(simids.empty() ? NULL : &simids);
+  std::map<boost::uuids::uuid, std::string>::iterator it;
+  for (it = cat.begin(); it != cat.end(); ++it) {
+    FullBackend* b = Open(it->second);
+    if (b->Tables().count(table) == 0)
+      continue;
+    QueryResult part = b->Query(table, conds);
+    if (qr.fields.empty()) {
+      qr = part;
+    } else {
+      qr.rows.insert(qr.rows.end(), part.rows.begin(), part.rows.end());
+    }
+  }
+
+  if (qr.fields.empty()) {
+    // none of the selected partitions have the table, the result is still
+    // expected to describe its columns.
+    FullBackend* b = FindTable(table);
+    if (b == NULL)
+      throw ValueError("Invalid table name " + table);
+    qr = b->Query(table, conds);
+    qr.rows.clear();
+  }
+  return qr;
+}
+
+std::map<std::string, DbTypes> PartitionBack::ColumnTypes(std::string table) {
+  FullBackend* b = FindTable(table);
+  if (b == NULL)
+    throw ValueError("Invalid table name " + table);
+  return b->ColumnTypes(table);
+}
+
+std::list<ColumnInfo> PartitionBack::Schema(std::string table) {
+  FullBackend* b = FindTable(table);
+  if (b == NULL)
+    throw ValueError("Invalid table name " + table);
+  return b->Schema(table);
+}
+
+std::set<std::string> PartitionBack::Tables() {
+  std::set<std::string> rtn;
+  std::map<boost::uuids::uuid, std::string> cat = Catalog(NULL);
+  std::map<boost::uuids::uuid, std::string>::iterator it;
+  for (it = cat.begin(); it != cat.end(); ++it) {
+    std::set<std::string> tbls = Open(it->second)->Tables();
+    rtn.insert(tbls.begin(), tbls.end());
+  }
+  return rtn;
+}
+
+std::vector<boost::uuids::uuid> PartitionBack::SimIds() {
+  std::vector<boost::uuids::uuid> rtn;
+  std::map<boost::uuids::uuid, std::string> cat = Catalog(NULL, true);
+  std::map<boost::uuids::uuid, std::string>::iterator it;
+  for (it = cat.begin(); it != cat.end(); ++it)
+    rtn.push_back(it->first);
+  return rtn;
+}
+
+FullBackend* PartitionBack::Partition(const boost::uuids::uuid& simid) {
+  if (writing_.count(simid) > 0)
+    return writing_[simid];
+
+  std::string sid = boost::uuids::to_string(simid);
+  std::string fname = sid + ext_;
+  SqlStatement::Ptr stmt = catalog_.Prepare(
+      "INSERT OR IGNORE INTO Partitions (SimId, File) VALUES (?, ?);");
+  stmt->BindText(1, sid.c_str());
+  stmt->BindText(2, fname.c_str());
+  stmt->Exec();
+
+  FullBackend* b = Open(fname);
+  writing_[simid] = b;
+  return b;
+}
+
+std::map<boost::uuids::uuid, std::string> PartitionBack::Catalog(
+    std::set<boost::uuids::uuid>* simids, bool live) {
+  std::map<boost::uuids::uuid, std::string> rtn;
+  boost::uuids::string_generator gen;
+  SqlStatement::Ptr stmt = catalog_.Prepare(
+      "SELECT SimId, File, Closed FROM Partitions;");
+  while (stmt->Step()) {
+    boost::uuids::uuid simid = gen(std::string(stmt->GetText(0, NULL)));
+    if (simids != NULL && simids->count(simid) == 0)
+      continue;
+    if (!live && stmt->GetInt(2) == 0 && writing_.count(simid) == 0)
+      continue;
+    rtn[simid] = std::string(stmt->GetText(1, NULL));
+  }
+  return rtn;
+}
+
+FullBackend* PartitionBack::Open(std::string fname) {
+  if (parts_.count(fname) > 0)
+    return parts_[fname];
+
+  std::string fpath = (fs::path(path_) / fname).string();
+  FullBackend* b;
+  if (fs::path(fname).extension().string() == ".h5") {
+    b = new Hdf5Back(fpath);
+  } else {
+    b = new SqliteBack(fpath);
+  }
+  parts_[fname] = b;
+  return b;
+}
+
+FullBackend* PartitionBack::FindTable(std::string table) {
+  std::map<boost::uuids::uuid, std::string> cat = Catalog(NULL);
+  std::map<boost::uuids::uuid, std::string>::iterator it;
+  for (it = cat.begin(); it != cat.end(); ++it) {
+    FullBackend* b = Open(it->second);
+    if (b->Tables().count(table) > 0)
+      return b;
+  }
+  return NULL;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,125 @@
+#ifndef CYCLUS_SRC_PARTITION_BACK_H_
+#define CYCLUS_SRC_PARTITION_BACK_H_
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/uuid/uuid.hpp>
+
+#include "query_backend.h"
+#include "sqlite_db.h"
+
+namespace cyclus {
+
+/// A Recorder backend that stores the output of many simulations in a single
+/// store, so that e.g. a parameter sweep of many concurrent cyclus processes
+/// does not need its output databases to be merged afterwards.
+///
+/// The store is a directory holding one partition database per simulation id
+/// along with a shared catalog. Every datum is routed to the partition of its
+/// SimId, which is created (and registered in the catalog) the first time that
+/// simulation records anything. Since each process only ever writes to the
+/// partitions of its own simulations, writers never contend for a file. Only
+/// the catalog is shared, and it is a small sqlite database that relies on
+/// sqlite's own file locking for safe concurrent registration.
+///
+/// Queries span every closed partition in the catalog, and so the store may
+/// be analyzed as a single database, even while a sweep is still running.
+/// A partition is marked closed in the catalog when its writer closes the
+/// backend. Until then, only the writer itself queries it, so no process
+/// ever opens a database that another process is writing to. The partitions
+/// of writers that crashed before closing are left out of queries.
+/// Conditions of the form SimId == x are pushed down to the catalog so that
+/// only the matching partitions are opened and scanned.
+///
+/// All data recorded through this backend must have the simulation id
+/// injected (see Recorder::inject_sim_id).
+class PartitionBack : public FullBackend {
+ public:
+  /// Opens (or creates) a partitioned store.
+  ///
+  /// @param path the directory of the store, it is created if it does not
+  /// exist.
+  /// @param ext the file extension, and thus backend type, of the partition
+  /// databases. Either ".sqlite" or ".h5".
+  PartitionBack(std::string path, std::string ext = ".sqlite");
+
+  virtual ~PartitionBack();
+
+  /// Routes each Datum object to the partition of its simulation id.
+  virtual void Notify(DatumList data);
+
+  /// Returns the path of the store.
+  virtual std::string Name();
+
+  /// Flushes all partitions that have been written to.
+  virtual void Flush();
+
+  /// Closes all open partitions and the catalog.
+  virtual void Close();
+
+  /// Returns the matching rows of the table from all closed partitions (and
+  /// those written by this backend), or only those of the simulations
+  /// selected by SimId == conditions.
+  virtual QueryResult Query(std::string table, std::vector<Cond>* conds);
+
+  virtual std::map<std::string, DbTypes> ColumnTypes(std::string table);
+
+  virtual std::list<ColumnInfo> Schema(std::string table);
+
+  /// Returns the union of the tables present in all queried partitions.
+  virtual std::set<std::string> Tables();
+
+  /// Returns the simulation ids of all partitions registered in the catalog.
+  std::vector<boost::uuids::uuid> SimIds();
+
+  /// Returns true if path names a partitioned store, i.e. it is an existing
+  /// directory or it ends with a path separator.
+  static bool IsStore(std::string path);
+
+  /// Name of the catalog database inside of the store directory.
+  static const char* kCatalogName;
+
+ private:
+  /// Returns the partition of a simulation, creating and registering it in
+  /// the catalog if needed.
+  FullBackend* Partition(const boost::uuids::uuid& simid);
+
+  /// Returns the file names of the partitions in the catalog, keyed by
+  /// simulation id. If simids is not NULL, only these are returned. Unless
+  /// live is true, partitions still being written by other writers are left
+  /// out.
+  std::map<boost::uuids::uuid, std::string> Catalog(
+      std::set<boost::uuids::uuid>* simids, bool live = false);
+
+  /// Opens (or returns the already open) partition database at fname,
+  /// relative to the store directory.
+  FullBackend* Open(std::string fname);
+
+  /// Returns the first partition containing the table, if any.
+  FullBackend* FindTable(std::string table);
+
+  /// Directory of the store.
+  std::string path_;
+
+  /// File extension of the partitions.
+  std::string ext_;
+
+  /// The shared catalog of partitions.
+  SqliteDb catalog_;
+
+  /// Partitions that this backend has opened, keyed by file name.
+  std::map<std::string, FullBackend*> parts_;
+
+  /// Partitions written to by this backend, keyed by simulation id.
+  std::map<boost::uuids::uuid, FullBackend*> writing_;
+
+  bool closed_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_PARTITION_BACK_H_
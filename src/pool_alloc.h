@@ -0,0 +1,96 @@
+#ifndef CYCLUS_SRC_POOL_ALLOC_H_
+#define CYCLUS_SRC_POOL_ALLOC_H_
+
+#include <cstddef>
+#include <utility>
+
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace cyclus {
+
+/// Allocation counters of the objects of a pooled type. PoolAllocator
+/// updates all of them in the same critical section, so they are consistent
+/// when read outside of parallel regions.
+struct PoolStats {
+  PoolStats() : allocs(0), frees(0), peak(0) {}
+
+  /// Returns the number of objects currently allocated.
+  unsigned long live() const { return allocs - frees; }
+
+  /// total number of objects allocated.
+  unsigned long allocs;
+
+  /// total number of objects freed.
+  unsigned long frees;
+
+  /// the largest number of objects allocated at once.
+  unsigned long peak;
+};
+
+/// Returns the allocation counters of the pooled type T.
+template <typename T>
+PoolStats& pool_stats() {
+  static PoolStats s;
+  return s;
+}
+
+/// A standard allocator that draws memory from boost's per-size fast pools,
+/// and counts its allocations in the PoolStats of Tag. Rebinding keeps the
+/// tag, so that memory allocated on behalf of a Tag object (e.g. by
+/// boost::allocate_shared) is counted as such.
+template <typename T, typename Tag>
+class PoolAllocator : public boost::fast_pool_allocator<T> {
+ public:
+  typedef boost::fast_pool_allocator<T> Base;
+  typedef typename Base::pointer pointer;
+  typedef typename Base::size_type size_type;
+
+  template <typename U>
+  struct rebind {
+    typedef PoolAllocator<U, Tag> other;
+  };
+
+  PoolAllocator() {}
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U, Tag>&) {}
+
+  static pointer allocate(size_type n) {
+    PoolStats& s = pool_stats<Tag>();
+    #pragma omp critical (cyclus_pool_stats)
+    {
+      s.allocs += n;
+      if (s.live() > s.peak)
+        s.peak = s.live();
+    }
+    return Base::allocate(n);
+  }
+
+  static pointer allocate(size_type n, const void*) {
+    return allocate(n);
+  }
+
+  static void deallocate(pointer p, size_type n) {
+    PoolStats& s = pool_stats<Tag>();
+    #pragma omp critical (cyclus_pool_stats)
+    s.frees += n;
+    Base::deallocate(p, n);
+  }
+};
+
+/// Creates a new T that is owned by a shared pointer to its Base. The object
+/// and the pointer's reference counts share a single pooled allocation, which
+/// is counted in the PoolStats of Base. T must be constructible from args,
+/// and is usually a trivial subclass of Base that makes Base's non-public
+/// constructors accessible.
+template <typename Base, typename T, typename... Args>
+boost::shared_ptr<Base> PoolNew(Args&&... args) {
+  return boost::allocate_shared<T>(PoolAllocator<T, Base>(),
+                                   std::forward<Args>(args)...);
+}
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_POOL_ALLOC_H_
@@ -2,13 +2,22 @@
 
 #include "error.h"
 #include "logger.h"
+#include "pool_alloc.h"
 
 namespace cyclus {
 
 const ResourceType Product::kType = "Product";
 
-std::map<std::string, int> Product::qualids_;
-int Product::next_qualid_ = 1;
+/// Products are allocated from a pool, together with the reference counts of
+/// their shared pointer.
+class Product::Pooled : public Product {
+ public:
+  template <typename... Args>
+  Pooled(Args&&... args) : Product(std::forward<Args>(args)...) {}
+};
+
+std::map<std::string, int64_t> Product::qualids_;
+int64_t Product::next_qualid_ = 1;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::Create(Agent* creator, double quantity,
@@ -22,7 +31,8 @@ Product::Ptr Product::Create(Agent* creator, double quantity,
   }
 
   // the next lines must come after qual id setting
-  Product::Ptr r(new Product(creator->context(), quantity, quality));
+  Product::Ptr r =
+      PoolNew<Product, Pooled>(creator->context(), quantity, quality);
   r->tracker_.Create(creator);
   return r;
 }
@@ -30,17 +40,17 @@ Product::Ptr Product::Create(Agent* creator, double quantity,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Product::Ptr Product::CreateUntracked(double quantity,
                                       std::string quality) {
-  Product::Ptr r(new Product(NULL, quantity, quality));
+  Product::Ptr r = PoolNew<Product, Pooled>(
+      static_cast<Context*>(NULL), quantity, quality);
   r->tracker_.DontTrack();
   return r;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Resource::Ptr Product::Clone() const {
-  Product* g = new Product(*this);
-  Resource::Ptr c = Resource::Ptr(g);
+  Product::Ptr g = PoolNew<Product, Pooled>(*this);
   g->tracker_.DontTrack();
-  return c;
+  return g;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -62,7 +72,8 @@ Product::Ptr Product::Extract(double quantity) {
 
   quantity_ -= quantity;
 
-  Product::Ptr other(new Product(ctx_, quantity, quality_));
+  Product::Ptr other =
+      PoolNew<Product, Pooled>(ctx_, quantity, quality_);
   tracker_.Extract(&other->tracker_);
   return other;
 }
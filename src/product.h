@@ -35,7 +35,7 @@ class Product : public Resource {
   static Ptr CreateUntracked(double quantity, std::string quality);
 
   /// Returns 0 (for now).
-  virtual int qual_id() const {
+  virtual int64_t qual_id() const {
     return qualids_[quality_];
   }
 
@@ -78,13 +78,16 @@ class Product : public Resource {
   Product(Context* ctx, double quantity, std::string quality);
 
   // map<quality, quality_id>
-  static std::map<std::string, int> qualids_;
-  static int next_qualid_;
+  static std::map<std::string, int64_t> qualids_;
+  static int64_t next_qualid_;
 
   Context* ctx_;
   std::string quality_;
   double quantity_;
   ResTracker tracker_;
+
+  /// the pool allocated type of all products (see PoolNew).
+  class Pooled;
 };
 
 }  // namespace cyclus
@@ -15,6 +15,7 @@ class ExchangeGraph;
 /// @brief The ProgSolver provides the implementation for a mathematical
 /// programming solution to a resource exchange graph.
 class ProgSolver: public ExchangeSolver {
+  friend class SimInit;
  public:
   static const int kDefaultTimeout = 5 * 60; // 5 * 60 s/min == 5 minutes
 
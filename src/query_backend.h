@@ -5,6 +5,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <stdint.h>
 
 #include <boost/uuid/sha1.hpp>
 
@@ -347,6 +348,17 @@ enum DbTypes {
   VL_MAP_PAIR_VL_STRING_STRING_INT, // ["std::map<std::pair<std::string, std::string>, int>, 4, ["HDF5","SQLite"], ["VL_MAP", ["PAIR", "VL_STRING", "STRING"], "INT"], false]
   VL_MAP_PAIR_VL_STRING_VL_STRING_INT, // ["std::map<std::pair<std::string, std::string>, int>, 4, ["HDF5","SQLite"], ["VL_MAP", ["PAIR", "VL_STRING", "VL_STRING"], "INT"], false]
 
+  // 64-bit integers, e.g. resource and composition ids
+  LONG,  // ["int64_t", 0, ["HDF5", "SQLite"], "LONG", false]
+
+  // maps to 64-bit integers, e.g. ResMap object ids
+  MAP_INT_LONG,  // ["std::map<int, int64_t>", 1, ["HDF5", "SQLite"], ["MAP", "INT", "LONG"], false]
+  VL_MAP_INT_LONG,  // ["std::map<int, int64_t>", 1, ["HDF5", "SQLite"], ["VL_MAP", "INT", "LONG"], true]
+  MAP_STRING_LONG,  // ["std::map<std::string, int64_t>", 2, ["HDF5", "SQLite"], ["MAP", "STRING", "LONG"], false]
+  VL_MAP_STRING_LONG,  // ["std::map<std::string, int64_t>", 2, ["HDF5", "SQLite"], ["VL_MAP", "STRING", "LONG"], true]
+  MAP_VL_STRING_LONG,  // ["std::map<std::string, int64_t>", 2, ["HDF5", "SQLite"], ["MAP", "VL_STRING", "LONG"], false]
+  VL_MAP_VL_STRING_LONG,  // ["std::map<std::string, int64_t>", 2, ["HDF5", "SQLite"], ["VL_MAP", "VL_STRING", "LONG"], true]
+
   // append new types only:
 };
 
@@ -683,6 +695,15 @@ class Digest {
   }
 };
 
+/// Hash function object so that Digests may be used as keys of unordered
+/// containers. A SHA1 is already uniformly distributed, so its leading words
+/// are used directly rather than being hashed again.
+struct DigestHash {
+  inline std::size_t operator()(const cyclus::Digest& d) const {
+    return static_cast<std::size_t>(d.val[0]) * 31 + d.val[1];
+  }
+};
+
 class Sha1 {
  public:
   Sha1() { hash_ = boost::uuids::detail::sha1(); }
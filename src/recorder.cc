@@ -11,22 +11,34 @@
 namespace cyclus {
 
 Recorder::Recorder() : index_(0), inject_sim_id_(true) {
+  routed_ = false;
+  sink_ = new Datum(this, "");
+  sink_->discard_ = true;
   uuid_ = boost::uuids::random_generator()();
   set_dump_count(kDefaultDumpCount);
 }
 
 Recorder::Recorder(bool inject_sim_id) : index_(0), inject_sim_id_(inject_sim_id) {
+  routed_ = false;
+  sink_ = new Datum(this, "");
+  sink_->discard_ = true;
   uuid_ = boost::uuids::random_generator()();
   set_dump_count(kDefaultDumpCount);
 }
 
 Recorder::Recorder(unsigned int dump_count) : index_(0), inject_sim_id_(true) {
+  routed_ = false;
+  sink_ = new Datum(this, "");
+  sink_->discard_ = true;
   uuid_ = boost::uuids::random_generator()();
   set_dump_count(dump_count);
 }
 
 Recorder::Recorder(boost::uuids::uuid simid) : index_(0), uuid_(simid), \
                                                inject_sim_id_(true) {
+  routed_ = false;
+  sink_ = new Datum(this, "");
+  sink_->discard_ = true;
   set_dump_count(kDefaultDumpCount);
 }
 
@@ -40,6 +52,7 @@ Recorder::~Recorder() {
   for (int i = 0; i < data_.size(); ++i) {
     delete data_[i];
   }
+  delete sink_;
 }
 
 unsigned int Recorder::dump_count() {
@@ -83,6 +96,51 @@ Datum* Recorder::NewDatum(std::string title) {
   return d;
 }
 
+Datum* Recorder::NewDatum(std::string title, int time) {
+  if (!policy_.empty() && Filtered(title, time)) {
+    return sink_;
+  }
+  return NewDatum(title);
+}
+
+void Recorder::set_policy(const RecordPolicy& p) {
+  bool routed = false;
+  RecordPolicy::const_iterator it;
+  for (it = p.begin(); it != p.end(); ++it) {
+    if (it->second.stride < 1) {
+      throw ValueError("recording stride of table '" + it->first +
+                       "' must be positive");
+    }
+    routed = routed || !it->second.backends.empty();
+  }
+  Flush();
+  policy_ = p;
+  routed_ = routed;
+}
+
+bool Recorder::Filtered(const std::string& title, int time) {
+  RecordPolicy::iterator it = policy_.find(title);
+  if (it == policy_.end()) {
+    return false;
+  }
+  const TablePolicy& tp = it->second;
+  return tp.drop || (tp.stride > 1 && time % tp.stride != 0);
+}
+
+DatumList Recorder::Routed(const DatumList& data, RecBackend* b) {
+  std::string name = b->Name();
+  DatumList rtn;
+  rtn.reserve(data.size());
+  for (int i = 0; i < data.size(); ++i) {
+    RecordPolicy::iterator it = policy_.find(data[i]->title_);
+    if (it == policy_.end() || it->second.backends.empty() ||
+        it->second.backends.count(name) > 0) {
+      rtn.push_back(data[i]);
+    }
+  }
+  return rtn;
+}
+
 void Recorder::AddDatum(Datum* d) {
   if (index_ >= data_.size()) {
     NotifyBackends();
@@ -97,7 +155,7 @@ void Recorder::Flush() {
   index_ = 0;
   std::list<RecBackend*>::iterator it;
   for (it = backs_.begin(); it != backs_.end(); it++) {
-    (*it)->Notify(tmp);
+    (*it)->Notify(routed_ ? Routed(tmp, *it) : tmp);
     (*it)->Flush();
   }
 }
@@ -106,7 +164,7 @@ void Recorder::NotifyBackends() {
   index_ = 0;
   std::list<RecBackend*>::iterator it;
   for (it = backs_.begin(); it != backs_.end(); it++) {
-    (*it)->Notify(data_);
+    (*it)->Notify(routed_ ? Routed(data_, *it) : data_);
   }
 }
 
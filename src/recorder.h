@@ -2,6 +2,8 @@
 #define CYCLUS_SRC_RECORDER_H_
 
 #include <list>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <boost/uuid/uuid.hpp>
@@ -20,6 +22,26 @@ typedef std::vector<Datum*> DatumList;
 /// default number of Datum objects to collect before flushing to backends.
 static unsigned int const kDefaultDumpCount = 10000;
 
+/// How the Recorder treats the Datum objects of a single table.
+struct TablePolicy {
+  TablePolicy() : drop(false), stride(1) {}
+
+  /// if true, nothing is recorded for the table.
+  bool drop;
+
+  /// the table is only recorded on time steps that are a multiple of the
+  /// stride. A stride of 1 records every time step.
+  int stride;
+
+  /// names (see RecBackend::Name) of the backends that receive the table. If
+  /// empty, the table goes to all registered backends.
+  std::set<std::string> backends;
+};
+
+/// Recording policies keyed by table title. Tables without an entry are
+/// recorded at every time step to every backend.
+typedef std::map<std::string, TablePolicy> RecordPolicy;
+
 /// Collects and manages output data generation for the cyclus core and agents
 /// during a simulation.  By default, datum managers are auto-initialized with a
 /// unique uuid simulation id.
@@ -79,6 +101,14 @@ class Recorder {
   /// returns the unique id associated with this cyclus simulation.
   boost::uuids::uuid sim_id();
 
+  /// sets the unique simulation id of the Datum objects created from now on.
+  /// Buffered Datum objects are flushed first under the old id.
+  void sim_id(boost::uuids::uuid id) {
+    Flush();
+    uuid_ = id;
+    set_dump_count(dump_count_);
+  };
+
   /// returns whether or not the unique simulation id will be injected.
   bool inject_sim_id() { return inject_sim_id_; };
 
@@ -100,6 +130,26 @@ class Recorder {
   /// (e.g. the same table).
   Datum* NewDatum(std::string title);
 
+  /// Creates a new datum namespaced under the specified title, recorded at
+  /// the given time step. If the recording policy filters out the table at
+  /// this time, a shared discarding datum is returned instead, on which
+  /// AddVal and Record do nothing.
+  Datum* NewDatum(std::string title, int time);
+
+  /// Returns the current recording policy.
+  const RecordPolicy& policy() { return policy_; }
+
+  /// Sets the recording policy. Any buffered Datum objects are flushed first
+  /// so that they are routed by the policy in effect when they were created.
+  ///
+  /// @warning dropping or sampling tables that the simulation reads back
+  /// (e.g. for restarting from a snapshot) makes them unusable for that.
+  void set_policy(const RecordPolicy& p);
+
+  /// Returns true if the recording policy filters out the table at the given
+  /// time step.
+  bool Filtered(const std::string& title, int time);
+
   /// Registers b to receive Datum notifications for all Datum objects collected
   /// by the Recorder and to receive a flush notification when there
   /// are no more Datum objects.
@@ -118,12 +168,22 @@ class Recorder {
   void NotifyBackends();
   void AddDatum(Datum* d);
 
+  /// Returns the Datum objects of data that are routed to backend b.
+  DatumList Routed(const DatumList& data, RecBackend* b);
+
   DatumList data_;
   int index_;
   std::list<RecBackend*> backs_;
   unsigned int dump_count_;
   boost::uuids::uuid uuid_;
   bool inject_sim_id_;
+  RecordPolicy policy_;
+
+  /// true if any table of the policy is routed to specific backends.
+  bool routed_;
+
+  /// returned by NewDatum in place of the Datum objects of filtered tables.
+  Datum* sink_;
 };
 
 }  // namespace cyclus
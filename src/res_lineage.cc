@@ -0,0 +1,104 @@
+#include "res_lineage.h"
+
+#include <algorithm>
+#include <map>
+
+#include "context.h"
+
+namespace cyclus {
+
+/// Appends id to ids unless it is already there.
+static void AddUnique(std::vector<int64_t>* ids, int64_t id) {
+  if (std::find(ids->begin(), ids->end(), id) == ids->end()) {
+    ids->push_back(id);
+  }
+}
+
+ResLineage::ResLineage(Context* ctx) : ctx_(ctx) {}
+
+void ResLineage::Add(Resource::Ptr state,
+                     const std::vector<int64_t>& parents, int creator) {
+  Node n;
+  n.state = state;
+  for (int i = 0; i < parents.size(); ++i) {
+    if (parents[i] != 0) {
+      AddUnique(&n.parents, parents[i]);
+    }
+  }
+  n.creator = creator;
+  nodes_.push_back(n);
+}
+
+void ResLineage::Pin(int64_t state_id) {
+  pinned_.insert(state_id);
+}
+
+void ResLineage::Flush() {
+  std::set<int64_t> superseded;
+  for (int i = 0; i < nodes_.size(); ++i) {
+    for (int j = 0; j < nodes_[i].parents.size(); ++j) {
+      superseded.insert(nodes_[i].parents[j]);
+    }
+  }
+
+  // nodes are in state id order, so parents are always resolved before their
+  // children.
+  std::map<int64_t, std::vector<int64_t> > dropped;
+  for (int i = 0; i < nodes_.size(); ++i) {
+    Node& n = nodes_[i];
+    int64_t id = n.state->state_id();
+
+    std::vector<int64_t> parents;
+    for (int j = 0; j < n.parents.size(); ++j) {
+      std::map<int64_t, std::vector<int64_t> >::iterator it = dropped.find(
+          n.parents[j]);
+      if (it == dropped.end()) {
+        AddUnique(&parents, n.parents[j]);
+        continue;
+      }
+      for (int k = 0; k < it->second.size(); ++k) {
+        AddUnique(&parents, it->second[k]);
+      }
+    }
+
+    if (!n.parents.empty() && superseded.count(id) > 0 &&
+        pinned_.count(id) == 0) {
+      dropped[id] = parents;
+      continue;
+    }
+
+    Resource::Ptr r = n.state;
+    ctx_->NewDatum("Resources")
+        ->AddVal("ResourceId", id)
+        ->AddVal("ObjId", r->obj_id())
+        ->AddVal("Type", r->type())
+        ->AddVal("TimeCreated", ctx_->time())
+        ->AddVal("Quantity", r->quantity())
+        ->AddVal("Units", r->units())
+        ->AddVal("QualId", r->qual_id())
+        ->AddVal("Parent1", parents.size() > 0 ? parents[0] : 0)
+        ->AddVal("Parent2", parents.size() > 1 ? parents[1] : 0)
+        ->Record();
+    if (parents.size() > 2) {
+      for (int j = 0; j < parents.size(); ++j) {
+        ctx_->NewDatum("ResourceParents")
+            ->AddVal("ResourceId", id)
+            ->AddVal("ParentId", parents[j])
+            ->Record();
+      }
+    }
+    r->Record(ctx_);
+
+    if (n.creator != -1) {
+      ctx_->NewDatum("ResCreators")
+          ->AddVal("ResourceId", id)
+          ->AddVal("AgentId", n.creator)
+          ->Record();
+    }
+  }
+
+  nodes_.clear();
+  pinned_.clear();
+}
+
+}  // namespace cyclus
@@ -0,0 +1,58 @@
+#ifndef CYCLUS_SRC_RES_LINEAGE_H_
+#define CYCLUS_SRC_RES_LINEAGE_H_
+
+#include <set>
+#include <vector>
+
+#include "resource.h"
+
+namespace cyclus {
+
+class Context;
+
+/// Collects the resource state transitions of a single time step so that
+/// their provenance can be recorded in a compacted form (see
+/// SimInfo::compact_provenance).
+///
+/// When the time step is flushed, every state that was created and then
+/// superseded within the step (e.g. a resource split off and absorbed again
+/// inside one Tock) is dropped, and the states derived from it inherit its
+/// parents. Only the remaining states get Resources entries and have their
+/// Record method called. States with no parents (newly created resources) and
+/// pinned states (e.g. ones recorded in the Transactions table) are always
+/// kept. A state that ends up with more than two parents lists all of them
+/// in the ResourceParents table.
+class ResLineage {
+ public:
+  ResLineage(Context* ctx);
+
+  /// Adds a new state of a resource.
+  /// @param state an untracked copy of the resource in the new state
+  /// @param parents the parent state ids, zeros are ignored
+  /// @param creator the id of the agent that created the resource, or -1 if
+  /// the state is not a newly created resource.
+  void Add(Resource::Ptr state, const std::vector<int64_t>& parents,
+           int creator = -1);
+
+  /// Marks the state as referenced from outside the provenance, so that it
+  /// is kept even if it is superseded within the time step.
+  void Pin(int64_t state_id);
+
+  /// Records the compacted states added since the last flush.
+  void Flush();
+
+ private:
+  struct Node {
+    Resource::Ptr state;
+    std::vector<int64_t> parents;
+    int creator;
+  };
+
+  Context* ctx_;
+  std::vector<Node> nodes_;
+  std::set<int64_t> pinned_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_RES_LINEAGE_H_
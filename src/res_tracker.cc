@@ -1,6 +1,7 @@
 #include "res_tracker.h"
 
 #include "recorder.h"
+#include "res_lineage.h"
 
 namespace cyclus {
 
@@ -22,6 +23,13 @@ void ResTracker::Create(Agent* creator) {
 
   parent1_ = 0;
   parent2_ = 0;
+  if (ctx_->lineage() != NULL) {
+    res_->BumpStateId();
+    ctx_->lineage()->Add(res_->Clone(), std::vector<int64_t>(),
+                         creator->id());
+    return;
+  }
+
   Record();
   ctx_->NewDatum("ResCreators")
       ->AddVal("ResourceId", res_->state_id())
@@ -64,7 +72,54 @@ void ResTracker::Absorb(ResTracker* absorbed) {
   Record();
 }
 
+void ResTracker::Absorb(const std::vector<ResTracker*>& absorbed) {
+  if (!tracked_ || absorbed.empty()) {
+    return;
+  }
+
+  if (ctx_->lineage() != NULL) {
+    // no intermediate states are needed in the compacted provenance
+    std::vector<int64_t> parents;
+    parents.push_back(res_->state_id());
+    for (int i = 0; i < absorbed.size(); ++i) {
+      parents.push_back(absorbed[i]->res_->state_id());
+    }
+    res_->BumpStateId();
+    ctx_->lineage()->Add(res_->Clone(), parents);
+    return;
+  }
+
+  // a single state with the combined quantity and composition. Like the
+  // compacted provenance, all parents are listed in ResourceParents if there
+  // are more than two.
+  std::vector<int64_t> parents;
+  parents.push_back(res_->state_id());
+  for (int i = 0; i < absorbed.size(); ++i) {
+    parents.push_back(absorbed[i]->res_->state_id());
+  }
+  parent1_ = parents[0];
+  parent2_ = parents[1];
+  Record();
+  if (parents.size() > 2) {
+    for (int i = 0; i < parents.size(); ++i) {
+      ctx_->NewDatum("ResourceParents")
+          ->AddVal("ResourceId", res_->state_id())
+          ->AddVal("ParentId", parents[i])
+          ->Record();
+    }
+  }
+}
+
 void ResTracker::Record() {
+  if (ctx_->lineage() != NULL) {
+    std::vector<int64_t> parents;
+    parents.push_back(parent1_);
+    parents.push_back(parent2_);
+    res_->BumpStateId();
+    ctx_->lineage()->Add(res_->Clone(), parents);
+    return;
+  }
+
   res_->BumpStateId();
   ctx_->NewDatum("Resources")
       ->AddVal("ResourceId", res_->state_id())
@@ -77,7 +132,6 @@ void ResTracker::Record() {
       ->AddVal("Parent1", parent1_)
       ->AddVal("Parent2", parent2_)
       ->Record();
-
   res_->Record(ctx_);
 }
 
@@ -18,7 +18,9 @@ namespace cyclus {
 /// Invocations to Create, Extract, Absorb, and Modify result in one or more
 /// entries in the output db Resource table and also call the Record method of
 /// the tracker's tracked resource.  A zero parent id indicates a resource id
-/// has no parent; if both are zeros the resource was newly created.
+/// has no parent; if both are zeros the resource was newly created.  If the
+/// simulation compacts provenance, the entries are collected by the context's
+/// ResLineage and only recorded when the time step is flushed.
 class ResTracker {
  public:
   /// Create a new tracker following r.
@@ -39,6 +41,14 @@ class ResTracker {
   /// @param absorbed the tracker of the resource being absorbed.
   void Absorb(ResTracker* absorbed);
 
+  /// Should be called when a resource is combined with several others at
+  /// once, after its quantity has been updated and while the absorbed
+  /// resources still have their state ids.  A single entry is recorded for
+  /// the combined state, with the absorbed resources listed in the
+  /// ResourceParents table if there is more than one.
+  /// @param absorbed the trackers of the resources being absorbed, in order.
+  void Absorb(const std::vector<ResTracker*>& absorbed);
+
   /// Should be called when the state of a resource changes (e.g. radioactive
   /// decay).
   void Modify();
@@ -46,8 +56,8 @@ class ResTracker {
  private:
   void Record();
 
-  int parent1_;
-  int parent2_;
+  int64_t parent1_;
+  int64_t parent2_;
   bool tracked_;
   Resource* res_;
   Context* ctx_;
@@ -2,8 +2,8 @@
 
 namespace cyclus {
 
-int Resource::nextstate_id_ = 1;
-int Resource::nextobj_id_ = 1;
+int64_t Resource::nextstate_id_ = 1;
+int64_t Resource::nextobj_id_ = 1;
 
 void Resource::BumpStateId() {
   state_id_ = nextstate_id_;
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_RESOURCE_H_
 #define CYCLUS_SRC_RESOURCE_H_
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -30,13 +31,13 @@ class Resource {
   /// Returns the unique id corresponding to this resource object. Can be used
   /// to track and/or associate other information with this resource object.
   /// You should NOT track resources by pointer.
-  const int obj_id() const { return obj_id_; }
+  const int64_t obj_id() const { return obj_id_; }
 
   /// Returns the unique id corresponding to this resource and its current
   /// state.  All resource id's are unique - even across different resource
   /// types/implementations. Runtime tracking of resources should generally
   /// use the obj_id rather than this.
-  const int state_id() const {
+  const int64_t state_id() const {
     return state_id_;
   }
 
@@ -50,7 +51,7 @@ class Resource {
   /// state that is not accessible via the Resource class public interface.  Any
   /// change to the qual_id should always be accompanied by a call to
   /// BumpStateId.
-  virtual int qual_id() const = 0;
+  virtual int64_t qual_id() const = 0;
 
   /// A unique type/name for the concrete resource implementation.
   virtual const ResourceType type() const = 0;
@@ -80,10 +81,10 @@ class Resource {
   virtual Ptr ExtractRes(double quantity) = 0;
 
  private:
-  static int nextstate_id_;
-  static int nextobj_id_;
-  int state_id_;
-  int obj_id_;
+  static int64_t nextstate_id_;
+  static int64_t nextobj_id_;
+  int64_t state_id_;
+  int64_t obj_id_;
 };
 
 /// Casts a vector of Resources into a vector of a specific resource type T.
@@ -1,9 +1,24 @@
 #include "sim_init.h"
 
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <deque>
+#include <sstream>
+#include <unordered_map>
+
+#include <boost/uuid/uuid_generators.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
 #include "prog_solver.h"
 #include "region.h"
+#include "res_lineage.h"
 
 namespace cyclus {
 
@@ -13,6 +28,156 @@ class Dummy : public Region {
   Dummy* Clone() { return NULL; }
 };
 
+/// Hashes the Datum objects of an agent snapshot, leaving out the SimId and
+/// SimTime fields so that unchanged state hashes the same at every snapshot.
+/// The data is kept so that a changed agent is recorded without taking its
+/// snapshot a second time.
+class SnapDigest : public RecBackend {
+ public:
+  SnapDigest() : hashable(true) {}
+
+  virtual void Notify(DatumList data) {
+    for (int i = 0; i < data.size(); ++i) {
+      kept_.push_back(Kept());
+      kept_.back().title = data[i]->title();
+      kept_.back().vals = data[i]->vals();
+      kept_.back().shapes = data[i]->shapes();
+
+      hash.Update(data[i]->title());
+      const Datum::Vals& vals = data[i]->vals();
+      for (int j = 0; j < vals.size(); ++j) {
+        std::string field = vals[j].first;
+        if (field == "SimId" || field == "SimTime") {
+          continue;
+        }
+        hash.Update(field);
+        hashable = Update(vals[j].second) && hashable;
+      }
+    }
+  }
+
+  virtual std::string Name() { return "SnapDigest"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  /// Records the kept data to the context's recorder under its simulation id.
+  void Replay(Context* ctx) {
+    for (int i = 0; i < kept_.size(); ++i) {
+      Datum* d = ctx->NewDatum(kept_[i].title);
+      const Datum::Vals& vals = kept_[i].vals;
+      for (int j = 0; j < vals.size(); ++j) {
+        if (std::string(vals[j].first) != "SimId") {
+          d->AddVal(vals[j].first, vals[j].second, &kept_[i].shapes[j]);
+        }
+      }
+      d->Record();
+    }
+  }
+
+  /// Hashes the raw bytes of a fixed size value.
+  template <typename T>
+  void UpdateBytes(const T& x) {
+    hash.Update(std::string(reinterpret_cast<const char*>(&x), sizeof(T)));
+  }
+
+  Sha1 hash;
+  /// false if a value of a type that cannot be hashed was seen
+  bool hashable;
+
+ private:
+  bool Update(const boost::spirit::hold_any& v) {
+#define CYCLUS_COMMA ,
+#define CYCLUS_HASHBYTES(T) \
+    if (v.type() == typeid(T)) { \
+      UpdateBytes(v.cast<T>()); \
+      return true; \
+    }
+#define CYCLUS_HASHVAL(T) \
+    if (v.type() == typeid(T)) { \
+      hash.Update(v.cast<T>()); \
+      return true; \
+    }
+
+    CYCLUS_HASHBYTES(int);
+    CYCLUS_HASHBYTES(int64_t);
+    CYCLUS_HASHBYTES(bool);
+    CYCLUS_HASHBYTES(double);
+    CYCLUS_HASHBYTES(float);
+    CYCLUS_HASHBYTES(boost::uuids::uuid);
+    CYCLUS_HASHVAL(std::string);
+    CYCLUS_HASHVAL(Blob);
+    CYCLUS_HASHVAL(std::vector<int>);
+    CYCLUS_HASHVAL(std::vector<double>);
+    CYCLUS_HASHVAL(std::vector<std::string>);
+    CYCLUS_HASHVAL(std::set<int>);
+    CYCLUS_HASHVAL(std::set<std::string>);
+    CYCLUS_HASHVAL(std::list<int>);
+    CYCLUS_HASHVAL(std::list<std::string>);
+    CYCLUS_HASHVAL(std::map<int CYCLUS_COMMA int>);
+    CYCLUS_HASHVAL(std::map<int CYCLUS_COMMA double>);
+    CYCLUS_HASHVAL(std::map<int CYCLUS_COMMA std::string>);
+    CYCLUS_HASHVAL(std::map<std::string CYCLUS_COMMA int>);
+    CYCLUS_HASHVAL(std::map<std::string CYCLUS_COMMA double>);
+    CYCLUS_HASHVAL(std::map<std::string CYCLUS_COMMA std::string>);
+    CYCLUS_HASHVAL(std::map<std::string CYCLUS_COMMA std::vector<double> >);
+    CYCLUS_HASHVAL(
+        std::map<std::string CYCLUS_COMMA std::map<int CYCLUS_COMMA double> >);
+    CYCLUS_HASHVAL(
+        std::map<int CYCLUS_COMMA std::map<std::string CYCLUS_COMMA double> >);
+    CYCLUS_HASHVAL(std::map<std::string CYCLUS_COMMA std::pair<
+                   double CYCLUS_COMMA std::map<int CYCLUS_COMMA double> > >);
+
+#undef CYCLUS_HASHVAL
+#undef CYCLUS_HASHBYTES
+#undef CYCLUS_COMMA
+    return false;
+  }
+
+  struct Kept {
+    std::string title;
+    Datum::Vals vals;
+    Datum::Shapes shapes;
+  };
+  std::vector<Kept> kept_;
+};
+
+/// Reads a resource, object or composition id. Databases written before ids
+/// were widened to 64 bits store them in INT columns.
+static int64_t GetId(QueryResult& qr, std::string field, int row = 0) {
+  for (int i = 0; i < qr.fields.size(); ++i) {
+    if (qr.fields[i] == field && qr.types[i] == INT) {
+      return qr.GetVal<int>(field, row);
+    }
+  }
+  return qr.GetVal<int64_t>(field, row);
+}
+
+/// Builds an equality condition on an id column, with the value typed to
+/// match the column so that it also works on older databases.
+static Cond IdCond(QueryableBackend* b, std::string table, std::string field,
+                   int64_t id) {
+  std::map<std::string, DbTypes> types = b->ColumnTypes(table);
+  if (types[field] == INT) {
+    return Cond(field, "==", static_cast<int>(id));
+  }
+  return Cond(field, "==", id);
+}
+
+struct SimInit::ResIndex {
+  /// the Resources rows of the indexed resource states
+  QueryResult resources;
+  /// ResourceId -> row in resources
+  std::unordered_map<int64_t, int> rows;
+  /// ResourceId -> PrevDecayTime
+  std::unordered_map<int64_t, int> prev_decay;
+  /// QualId -> mass fractions of the composition
+  std::unordered_map<int64_t, CompMap> compmaps;
+  /// QualId -> composition, shared by all materials that use it
+  std::unordered_map<int64_t, Composition::Ptr> comps;
+  /// QualId -> product quality
+  std::unordered_map<int64_t, std::string> qualities;
+};
+
 SimInit::SimInit() : rec_(NULL), ctx_(NULL) {}
 
 SimInit::~SimInit() {
@@ -59,6 +224,7 @@ void SimInit::InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t) {
   LoadRecipes();
   LoadSolverInfo();
   LoadPrototypes();
+  LoadSnapTimes();
   LoadInitialAgents();
   LoadInventories();
   LoadBuildSched();
@@ -70,51 +236,257 @@ void SimInit::InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t) {
   rec_->Flush();
 }
 
+int SimInit::ForkBranches(Context* ctx, int t, int n,
+                          std::function<RecBackend*(int)> back) {
+  ctx->ti_->RunUntil(t);
+  if (ctx->time() != t) {
+    throw ValueError("simulation ended before the branch time");
+  }
+
+  // nothing may be left buffered, or every worker would record it again
+  Recorder* rec = ctx->rec_;
+  rec->Flush();
+  fflush(NULL);
+  boost::uuids::uuid parent = rec->sim_id();
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < n; ++i) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      throw Error("failed to fork simulation branch");
+    } else if (pid > 0) {
+      pids.push_back(pid);
+      continue;
+    }
+
+#ifdef _OPENMP
+    // the OpenMP thread pool of the parent process is not inherited, and
+    // waking it from a parallel region would hang the worker
+    omp_set_num_threads(1);
+#endif
+
+    // the inherited backends are still in use by the parent process, so they
+    // are dropped without being closed.
+    rec->Close();
+    rec->sim_id(boost::uuids::random_generator()());
+    rec->RegisterBackend(back(i));
+
+    SimInfo si = ctx->sim_info();
+    si.parent_sim = parent;
+    si.parent_type = "branch";
+    si.branch_time = t;
+    ctx->InitSim(si);
+    SnapSetup(ctx);
+    ctx->snap_digests_.clear();  // the first snapshot must be a full one
+    Snapshot(ctx);
+    ctx->ti_->want_snapshot_ = false;  // one was just taken
+    return i;
+  }
+
+  int failed = 0;
+  for (int i = 0; i < pids.size(); ++i) {
+    int status;
+    if (waitpid(pids[i], &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      failed++;
+    }
+  }
+  if (failed > 0) {
+    std::stringstream ss;
+    ss << failed;
+    throw Error(ss.str() + " simulation branch(es) failed");
+  }
+  return -1;
+}
+
+void SimInit::SnapSetup(Context* ctx) {
+  // everything was recorded by the parent simulation, so it must all be
+  // recorded again.
+  Composition::record_epoch_++;
+  ctx->rec_ver_.clear();
+  int t = ctx->time();
+
+  std::map<std::string, Composition::Ptr>::iterator rit;
+  for (rit = ctx->recipes_.begin(); rit != ctx->recipes_.end(); ++rit) {
+    ctx->AddRecipe(rit->first, rit->second);
+    rit->second->Record(ctx);
+  }
+
+  std::map<std::string, int64_t>::iterator qit;
+  for (qit = Product::qualids_.begin(); qit != Product::qualids_.end();
+       ++qit) {
+    ctx->NewDatum("Products")
+        ->AddVal("QualId", qit->second)
+        ->AddVal("Quality", qit->first)
+        ->Record();
+  }
+
+  // the lazily created default solver is a greedy one without exclusive
+  // orders.
+  ExchangeSolver* solver = ctx->solver_;
+  ProgSolver* prog = dynamic_cast<ProgSolver*>(solver);
+  bool exclusive = solver != NULL && solver->exclusive_orders();
+  ctx->NewDatum("SolverInfo")
+      ->AddVal("Solver", std::string(prog != NULL ? "coin-or" : "greedy"))
+      ->AddVal("ExclusiveOrders", exclusive)
+      ->Record();
+  if (prog != NULL) {
+    ctx->NewDatum("CoinSolverInfo")
+        ->AddVal("Timeout", prog->tmax_)
+        ->AddVal("Verbose", prog->verbose_)
+        ->AddVal("Mps", prog->mps_)
+        ->Record();
+  } else {
+    ctx->NewDatum("GreedySolverInfo")
+        ->AddVal("Preconditioner", std::string("greedy"))
+        ->Record();
+  }
+
+  // the commodity priorities the greedy preconditioner was built from
+  GreedySolver* greedy = dynamic_cast<GreedySolver*>(solver);
+  if (greedy != NULL && greedy->conditioner_ != NULL) {
+    std::map<std::string, double>& prio =
+        greedy->conditioner_->commod_priority_;
+    std::map<std::string, double>::iterator cit;
+    for (cit = prio.begin(); cit != prio.end(); ++cit) {
+      ctx->NewDatum("CommodPriority")
+          ->AddVal("Commodity", cit->first)
+          ->AddVal("SolutionPriority", cit->second)
+          ->Record();
+    }
+  }
+
+  std::map<std::string, Agent*>::iterator pit;
+  for (pit = ctx->protos_.begin(); pit != ctx->protos_.end(); ++pit) {
+    ctx->AddPrototype(pit->first, pit->second, true);
+  }
+
+  // living agents and the resources in all inventories. Resources get no
+  // parents, their history is in the parent simulation's output.
+  std::set<Agent*>::iterator it;
+  for (it = ctx->agent_list_.begin(); it != ctx->agent_list_.end(); ++it) {
+    Agent* m = *it;
+    if (m->enter_time() != -1) {
+      m->AddToTable();
+    }
+
+    Inventories invs = m->SnapshotInv();
+    Inventories::iterator iit;
+    for (iit = invs.begin(); iit != invs.end(); ++iit) {
+      for (int i = 0; i < iit->second.size(); ++i) {
+        Resource::Ptr r = iit->second[i];
+        ctx->NewDatum("Resources")
+            ->AddVal("ResourceId", r->state_id())
+            ->AddVal("ObjId", r->obj_id())
+            ->AddVal("Type", r->type())
+            ->AddVal("TimeCreated", t)
+            ->AddVal("Quantity", r->quantity())
+            ->AddVal("Units", r->units())
+            ->AddVal("QualId", r->qual_id())
+            ->AddVal("Parent1", static_cast<int64_t>(0))
+            ->AddVal("Parent2", static_cast<int64_t>(0))
+            ->Record();
+        r->Record(ctx);
+      }
+    }
+  }
+
+  Timer* ti = ctx->ti_;
+  std::map<int, std::vector<std::pair<std::string, Agent*> > >::iterator bit;
+  for (bit = ti->build_queue_.lower_bound(t); bit != ti->build_queue_.end();
+       ++bit) {
+    for (int i = 0; i < bit->second.size(); ++i) {
+      Agent* parent = bit->second[i].second;
+      ctx->NewDatum("BuildSchedule")
+          ->AddVal("ParentId", parent != NULL ? parent->id() : -1)
+          ->AddVal("Prototype", bit->second[i].first)
+          ->AddVal("SchedTime", t)
+          ->AddVal("BuildTime", bit->first)
+          ->Record();
+    }
+  }
+
+  std::map<int, std::vector<Agent*> >::iterator dit;
+  for (dit = ti->decom_queue_.lower_bound(t); dit != ti->decom_queue_.end();
+       ++dit) {
+    for (int i = 0; i < dit->second.size(); ++i) {
+      ctx->NewDatum("DecomSchedule")
+          ->AddVal("AgentId", dit->second[i]->id())
+          ->AddVal("SchedTime", t)
+          ->AddVal("DecomTime", dit->first)
+          ->Record();
+    }
+  }
+}
+
 void SimInit::Snapshot(Context* ctx) {
   ctx->NewDatum("Snapshots")
      ->AddVal("Time", ctx->time())
      ->Record();
 
   // snapshot all agent internal state
+  bool delta = ctx->si_.delta_snapshots;
+  Recorder rec(static_cast<unsigned int>(100));
+  std::map<int, Digest> digests;
   std::set<Agent*> mlist = ctx->agent_list_;
   std::set<Agent*>::iterator it;
   for (it = mlist.begin(); it != mlist.end(); ++it) {
     Agent* m = *it;
-    if (m->enter_time() != -1) {
+    if (m->enter_time() == -1) {
+      continue;
+    }
+    if (!delta) {
       SimInit::SnapAgent(m);
+      continue;
+    }
+
+    // only record agents that changed since their last recorded snapshot.
+    // Agents with state that cannot be hashed are always recorded.
+    SnapDigest back;
+    Inventories invs;
+    bool hashable = AgentDigest(m, &rec, &back, &invs);
+    Digest d = back.hash.digest();
+    std::map<int, Digest>::iterator prev = ctx->snap_digests_.find(m->id());
+    if (!hashable || prev == ctx->snap_digests_.end() || prev->second != d) {
+      back.Replay(ctx);
+      SnapInventories(m, invs);
+    }
+    if (hashable) {
+      digests[m->id()] = d;
     }
   }
+  ctx->snap_digests_ = digests;
 
   // snapshot all next ids
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Agent"))
-      ->AddVal("NextId", Agent::next_id_)
+      ->AddVal("NextId", static_cast<int64_t>(Agent::next_id_))
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Transaction"))
-      ->AddVal("NextId", ctx->trans_id_)
+      ->AddVal("NextId", static_cast<int64_t>(ctx->trans_id_))
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Composition"))
-      ->AddVal("NextId", Composition::next_id_)
+      ->AddVal("NextId", static_cast<int64_t>(Composition::next_id_))
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceState"))
-      ->AddVal("NextId", Resource::nextstate_id_)
+      ->AddVal("NextId", static_cast<int64_t>(Resource::nextstate_id_))
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("ResourceObj"))
-      ->AddVal("NextId", Resource::nextobj_id_)
+      ->AddVal("NextId", static_cast<int64_t>(Resource::nextobj_id_))
       ->Record();
   ctx->NewDatum("NextIds")
       ->AddVal("Time", ctx->time())
       ->AddVal("Object", std::string("Product"))
-      ->AddVal("NextId", Product::next_qualid_)
+      ->AddVal("NextId", static_cast<int64_t>(Product::next_qualid_))
       ->Record();
 }
 
@@ -124,14 +496,19 @@ void SimInit::SnapAgent(Agent* m) {
   m->Agent::Snapshot(DbInit(m, true));
 
   m->Snapshot(DbInit(m));
-  Inventories invs = m->SnapshotInv();
-  Context* ctx = m->context();
+  SnapInventories(m, m->SnapshotInv());
+}
 
-  Inventories::iterator it;
+void SimInit::SnapInventories(Agent* m, const Inventories& invs) {
+  Context* ctx = m->context();
+  Inventories::const_iterator it;
   for (it = invs.begin(); it != invs.end(); ++it) {
     std::string name = it->first;
-    std::vector<Resource::Ptr> inv = it->second;
+    const std::vector<Resource::Ptr>& inv = it->second;
     for (int i = 0; i < inv.size(); ++i) {
+      if (ctx->lineage() != NULL) {
+        ctx->lineage()->Pin(inv[i]->state_id());
+      }
       ctx->NewDatum("AgentStateInventories")
           ->AddVal("AgentId", m->id())
           ->AddVal("SimTime", ctx->time())
@@ -142,6 +519,36 @@ void SimInit::SnapAgent(Agent* m) {
   }
 }
 
+bool SimInit::AgentDigest(Agent* m, Recorder* rec, SnapDigest* back,
+                          Inventories* invs) {
+  Context* ctx = m->context();
+  rec->RegisterBackend(back);
+  Recorder* orig = ctx->rec_;
+  ctx->rec_ = rec;
+  try {
+    m->Agent::Snapshot(DbInit(m, true));
+    m->Snapshot(DbInit(m));
+  } catch (...) {
+    ctx->rec_ = orig;
+    rec->Close();
+    throw;
+  }
+  ctx->rec_ = orig;
+  rec->Flush();
+
+  *invs = m->SnapshotInv();
+  Inventories::iterator it;
+  for (it = invs->begin(); it != invs->end(); ++it) {
+    back->hash.Update(it->first);
+    for (int i = 0; i < it->second.size(); ++i) {
+      back->UpdateBytes(it->second[i]->state_id());
+    }
+  }
+
+  rec->Close();
+  return back->hashable;
+}
+
 void SimInit::LoadInfo() {
   QueryResult qr = b_->Query("Info", NULL);
   int dur = qr.GetVal<int>("Duration");
@@ -167,6 +574,28 @@ void SimInit::LoadInfo() {
   si_.explicit_inventory = qr.GetVal<bool>("RecordInventory");
   si_.explicit_inventory_compact = qr.GetVal<bool>("RecordInventoryCompact");
 
+  try {
+    qr = b_->Query("DecayInterval", NULL);
+    si_.decay_interval = qr.GetVal<int>("Interval");
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("ProvenanceMode", NULL);
+    si_.compact_provenance = qr.GetVal<bool>("Compact");
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("SnapshotMode", NULL);
+    si_.delta_snapshots = qr.GetVal<bool>("Delta");
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
+  try {
+    qr = b_->Query("CheckpointPolicy", NULL);
+    si_.checkpoint_interval = qr.GetVal<int>("Interval");
+    si_.checkpoint_wall = qr.GetVal<double>("WallSecs");
+    si_.checkpoint_backoff = qr.GetVal<double>("BackoffSecs");
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
   ctx_->InitSim(si_);
 }
 
@@ -180,7 +609,7 @@ void SimInit::LoadRecipes() {
 
   for (int i = 0; i < qr.rows.size(); ++i) {
     std::string recipe = qr.GetVal<std::string>("Recipe", i);
-    int stateid = qr.GetVal<int>("QualId", i);
+    int64_t stateid = GetId(qr, "QualId", i);
     Composition::Ptr c = LoadComposition(b_, stateid);
     ctx_->AddRecipe(recipe, c);
   }
@@ -195,7 +624,7 @@ void* SimInit::LoadPreconditioner(std::string name) {
     QueryResult qr = b_->Query("CommodPriority", NULL);
     for (int i = 0; i < qr.rows.size(); ++i) {
       std::string commod = qr.GetVal<string>("Commodity", i);
-      double order = qr.GetVal<double>("SolutionOrder", i);
+      double order = qr.GetVal<double>("SolutionPriority", i);
       commod_order[commod] = order;
     }
   } catch (std::exception err) {
@@ -319,6 +748,33 @@ void SimInit::LoadPrototypes() {
   }
 }
 
+void SimInit::LoadSnapTimes() {
+  if (!si_.delta_snapshots) {
+    return;
+  }
+
+  // every agent snapshot records an AgentStateAgent row, so the latest one
+  // at or before t_ gives the snapshot that holds the agent's current state.
+  std::vector<Cond> conds;
+  conds.push_back(Cond("SimTime", "<=", t_));
+  QueryResult qr = b_->Query("AgentStateAgent", &conds);
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    int id = qr.GetVal<int>("AgentId", i);
+    int time = qr.GetVal<int>("SimTime", i);
+    if (snap_times_.count(id) == 0 || snap_times_[id] < time) {
+      snap_times_[id] = time;
+    }
+  }
+}
+
+int SimInit::SnapTime(int agentid) {
+  std::map<int, int>::iterator it = snap_times_.find(agentid);
+  if (it == snap_times_.end()) {
+    return t_;
+  }
+  return it->second;
+}
+
 void SimInit::LoadInitialAgents() {
   // DO NOT call the agents' Build methods because the agents might modify the
   // state of their children and/or the simulation in ways that are only meant
@@ -329,7 +785,19 @@ void SimInit::LoadInitialAgents() {
   std::vector<Cond> conds;
   conds.push_back(Cond("EnterTime", "<=", t_));
   QueryResult qentry = b_->Query("AgentEntry", &conds);
-  std::map<int, int> parentmap;  // map<agentid, parentid>
+
+  // find all agents that were decommissioned before the current timestep
+  std::set<int> exited;
+  conds.clear();
+  conds.push_back(Cond("ExitTime", "<", t_));
+  try {
+    QueryResult qexit = b_->Query("AgentExit", &conds);
+    for (int i = 0; i < qexit.rows.size(); ++i) {
+      exited.insert(qexit.GetVal<int>("AgentId", i));
+    }
+  } catch (std::exception err) {}  // table doesn't exist (okay)
+
+  std::map<int, std::vector<int> > children;  // map<parentid, agentids>
   std::map<int, Agent*> unbuilt;  // map<agentid, agent_ptr>
   for (int i = 0; i < qentry.rows.size(); ++i) {
     if (t_ > 0 && qentry.GetVal<int>("EnterTime", i) == t_) {
@@ -337,15 +805,9 @@ void SimInit::LoadInitialAgents() {
       continue;
     }
     int id = qentry.GetVal<int>("AgentId", i);
-    std::vector<Cond> conds;
-    conds.push_back(Cond("AgentId", "==", id));
-    conds.push_back(Cond("ExitTime", "<", t_));
-    try {
-      QueryResult qexit = b_->Query("AgentExit", &conds);
-      if (qexit.rows.size() != 0) {
-        continue;  // agent was decomissioned before t_ - skip
-      }
-    } catch (std::exception err) {}  // table doesn't exist (okay)
+    if (exited.count(id) > 0) {
+      continue;  // agent was decomissioned before t_ - skip
+    }
 
     // if the agent wasn't decommissioned before t_ create and init it
 
@@ -359,11 +821,12 @@ void SimInit::LoadInitialAgents() {
     m->id_ = id;
     m->enter_time_ = qentry.GetVal<int>("EnterTime", i);
     unbuilt[id] = m;
-    parentmap[id] = qentry.GetVal<int>("ParentId", i);
+    children[qentry.GetVal<int>("ParentId", i)].push_back(id);
 
     // agent-custom init
-    conds.pop_back();
-    conds.push_back(Cond("SimTime", "==", t_));
+    std::vector<Cond> conds;
+    conds.push_back(Cond("AgentId", "==", id));
+    conds.push_back(Cond("SimTime", "==", SnapTime(id)));
     CondInjector ci(b_, conds);
     PrefixInjector pi(&ci, "AgentState");
     m->Agent::InitFrom(&pi);
@@ -371,33 +834,36 @@ void SimInit::LoadInitialAgents() {
     m->InitFrom(&pi);
   }
 
-  // construct agent hierarchy starting at roots (no parent) down
-  std::map<int, Agent*>::iterator it = unbuilt.begin();
+  // construct agent hierarchy breadth-first from the roots (no parent) down,
+  // so that every parent is connected before its children.
   std::vector<Agent*> enter_list;
-  while (unbuilt.size() > 0) {
-    int id = it->first;
-    Agent* m = it->second;
-    int parentid = parentmap[id];
-
-    if (parentid == -1) {  // root agent
-      m->Connect(NULL);
-      agents_[id] = m;
-      ++it;
-      unbuilt.erase(id);
-      enter_list.push_back(m);
-    } else if (agents_.count(parentid) > 0) {  // parent is built
-      m->Connect(agents_[parentid]);
-      agents_[id] = m;
-      ++it;
-      unbuilt.erase(id);
-      enter_list.push_back(m);
-    } else {  // parent not built yet
-      ++it;
+  std::deque<std::pair<int, Agent*> > queue;  // <agentid, parent>
+  for (int i = 0; i < children[-1].size(); ++i) {
+    queue.push_back(std::make_pair(children[-1][i], (Agent*)NULL));
+  }
+  while (!queue.empty()) {
+    int id = queue.front().first;
+    Agent* m = unbuilt[id];
+    m->Connect(queue.front().second);
+    queue.pop_front();
+    unbuilt.erase(id);
+    agents_[id] = m;
+    enter_list.push_back(m);
+
+    std::map<int, std::vector<int> >::iterator it = children.find(id);
+    if (it == children.end()) {
+      continue;
     }
-    if (it == unbuilt.end()) {
-      it = unbuilt.begin();
+    for (int i = 0; i < it->second.size(); ++i) {
+      queue.push_back(std::make_pair(it->second[i], m));
     }
   }
+  if (unbuilt.size() > 0) {
+    std::stringstream ss;
+    ss << unbuilt.begin()->first;
+    throw IOError("Agent " + ss.str() + " has no living parent in the "
+                  "output database");
+  }
 
   // notify all agents that they are active in a simulation AFTER the
   // parent-child hierarchy has been reconstructed.
@@ -407,24 +873,45 @@ void SimInit::LoadInitialAgents() {
 }
 
 void SimInit::LoadInventories() {
+  // read the inventories of all agents at once and build their resources
+  // from a single scan of each resource table.
+  // with delta snapshots, each agent's inventories are the ones recorded
+  // with its last snapshot.
+  std::vector<Cond> conds;
+  conds.push_back(Cond("SimTime", si_.delta_snapshots ? "<=" : "==", t_));
+  QueryResult qr;
+  try {
+    qr = b_->Query("AgentStateInventories", &conds);
+  } catch (std::exception err) {return;}  // table doesn't exist (okay)
+
+  std::vector<int> rows;
+  std::set<int64_t> ids;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    int agentid = qr.GetVal<int>("AgentId", i);
+    if (qr.GetVal<int>("SimTime", i) != SnapTime(agentid)) {
+      continue;
+    }
+    rows.push_back(i);
+    ids.insert(GetId(qr, "ResourceId", i));
+  }
+  ResIndex idx;
+  IndexResources(b_, t_, ids, &idx);
+
+  Agent* dummy = new Dummy(ctx_);
+  std::map<int, Inventories> invs;
+  for (int j = 0; j < rows.size(); ++j) {
+    int i = rows[j];
+    int agentid = qr.GetVal<int>("AgentId", i);
+    std::string inv_name = qr.GetVal<std::string>("InventoryName", i);
+    int64_t state_id = GetId(qr, "ResourceId", i);
+    invs[agentid][inv_name].push_back(LoadResource(dummy, &idx, state_id));
+  }
+  ctx_->DelAgent(dummy);
+
   std::map<int, Agent*>::iterator it;
   for (it = agents_.begin(); it != agents_.end(); ++it) {
     Agent* m = it->second;
-    std::vector<Cond> conds;
-    conds.push_back(Cond("SimTime", "==", t_));
-    conds.push_back(Cond("AgentId", "==", m->id()));
-    QueryResult qr;
-    try {
-      qr = b_->Query("AgentStateInventories", &conds);
-    } catch (std::exception err) {return;}  // table doesn't exist (okay)
-
-    Inventories invs;
-    for (int i = 0; i < qr.rows.size(); ++i) {
-      std::string inv_name = qr.GetVal<std::string>("InventoryName", i);
-      int state_id = qr.GetVal<int>("ResourceId", i);
-      invs[inv_name].push_back(LoadResource(ctx_, b_, state_id));
-    }
-    m->InitInv(invs);
+    m->InitInv(invs[m->id()]);
   }
 }
 
@@ -465,25 +952,26 @@ void SimInit::LoadNextIds() {
   QueryResult qr = b_->Query("NextIds", &conds);
   for (int i = 0; i < qr.rows.size(); ++i) {
     std::string obj = qr.GetVal<std::string>("Object", i);
+    int64_t next_id = GetId(qr, "NextId", i);
     if (obj == "Agent") {
-      Agent::next_id_ = qr.GetVal<int>("NextId", i);
+      Agent::next_id_ = next_id;
     } else if (obj == "Transaction") {
-      ctx_->trans_id_ = qr.GetVal<int>("NextId", i);
+      ctx_->trans_id_ = next_id;
     } else if (obj == "Composition") {
-      Composition::next_id_ = qr.GetVal<int>("NextId", i);
+      Composition::next_id_ = next_id;
     } else if (obj == "ResourceState") {
-      Resource::nextstate_id_ = qr.GetVal<int>("NextId", i);
+      Resource::nextstate_id_ = next_id;
     } else if (obj == "ResourceObj") {
-      Resource::nextobj_id_ = qr.GetVal<int>("NextId", i);
+      Resource::nextobj_id_ = next_id;
     } else if (obj == "Product") {
-      Product::next_qualid_ = qr.GetVal<int>("NextId", i);
+      Product::next_qualid_ = next_id;
     } else {
       throw IOError("Unexpected value in NextIds table: " + obj);
     }
   }
 }
 
-Material::Ptr SimInit::BuildMaterial(QueryableBackend* b, int resid) {
+Material::Ptr SimInit::BuildMaterial(QueryableBackend* b, int64_t resid) {
   Timer ti;
   Recorder rec;
   Context ctx(&ti, &rec);
@@ -497,7 +985,7 @@ Material::Ptr SimInit::BuildMaterial(QueryableBackend* b, int resid) {
   return m;
 }
 
-Product::Ptr SimInit::BuildProduct(QueryableBackend* b, int resid) {
+Product::Ptr SimInit::BuildProduct(QueryableBackend* b, int64_t resid) {
   Timer ti;
   Recorder rec;
   Context ctx(&ti, &rec);
@@ -511,12 +999,13 @@ Product::Ptr SimInit::BuildProduct(QueryableBackend* b, int resid) {
   return p;
 }
 
-Resource::Ptr SimInit::LoadResource(Context* ctx, QueryableBackend* b, int state_id) {
+Resource::Ptr SimInit::LoadResource(Context* ctx, QueryableBackend* b,
+                                     int64_t state_id) {
   std::vector<Cond> conds;
-  conds.push_back(Cond("ResourceId", "==", state_id));
+  conds.push_back(IdCond(b, "Resources", "ResourceId", state_id));
   QueryResult qr = b->Query("Resources", &conds);
   ResourceType type = qr.GetVal<ResourceType>("Type");
-  int obj_id = qr.GetVal<int>("ObjId");
+  int64_t obj_id = GetId(qr, "ObjId");
 
   Resource::Ptr r;
   if (type == Material::kType) {
@@ -532,19 +1021,20 @@ Resource::Ptr SimInit::LoadResource(Context* ctx, QueryableBackend* b, int state
   return r;
 }
 
-Material::Ptr SimInit::LoadMaterial(Context* ctx, QueryableBackend* b, int state_id) {
+Material::Ptr SimInit::LoadMaterial(Context* ctx, QueryableBackend* b,
+                                    int64_t state_id) {
   // get special material object state
   std::vector<Cond> conds;
-  conds.push_back(Cond("ResourceId", "==", state_id));
+  conds.push_back(IdCond(b, "MaterialInfo", "ResourceId", state_id));
   QueryResult qr = b->Query("MaterialInfo", &conds);
   int prev_decay = qr.GetVal<int>("PrevDecayTime");
 
   // get general resource object info
   conds.clear();
-  conds.push_back(Cond("ResourceId", "==", state_id));
+  conds.push_back(IdCond(b, "Resources", "ResourceId", state_id));
   qr = b->Query("Resources", &conds);
   double qty = qr.GetVal<double>("Quantity");
-  int stateid = qr.GetVal<int>("QualId");
+  int64_t stateid = GetId(qr, "QualId");
 
   // create the composition and material
   Composition::Ptr comp = LoadComposition(b, stateid);
@@ -556,9 +1046,10 @@ Material::Ptr SimInit::LoadMaterial(Context* ctx, QueryableBackend* b, int state
   return mat;
 }
 
-Composition::Ptr SimInit::LoadComposition(QueryableBackend* b, int stateid) {
+Composition::Ptr SimInit::LoadComposition(QueryableBackend* b,
+                                          int64_t stateid) {
   std::vector<Cond> conds;
-  conds.push_back(Cond("QualId", "==", stateid));
+  conds.push_back(IdCond(b, "Compositions", "QualId", stateid));
   QueryResult qr = b->Query("Compositions", &conds);
   CompMap cm;
   for (int i = 0; i < qr.rows.size(); ++i) {
@@ -572,17 +1063,110 @@ Composition::Ptr SimInit::LoadComposition(QueryableBackend* b, int stateid) {
   return c;
 }
 
-Product::Ptr SimInit::LoadProduct(Context* ctx, QueryableBackend* b, int state_id) {
+void SimInit::IndexResources(QueryableBackend* b, int t,
+                             const std::set<int64_t>& ids, ResIndex* idx) {
+  if (ids.empty()) {
+    return;
+  }
+
+  std::vector<Cond> conds;
+  conds.push_back(Cond("TimeCreated", "<=", t));
+  idx->resources = b->Query("Resources", &conds);
+  QueryResult& qr = idx->resources;
+  std::set<int64_t> qualids;
+  bool materials = false;
+  bool products = false;
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    int64_t id = GetId(qr, "ResourceId", i);
+    if (ids.count(id) == 0) {
+      continue;
+    }
+    idx->rows[id] = i;
+    qualids.insert(GetId(qr, "QualId", i));
+    std::string type = qr.GetVal<std::string>("Type", i);
+    materials = materials || type == Material::kType;
+    products = products || type == Product::kType;
+  }
+
+  if (materials) {
+    QueryResult q = b->Query("MaterialInfo", NULL);
+    for (int i = 0; i < q.rows.size(); ++i) {
+      int64_t id = GetId(q, "ResourceId", i);
+      if (idx->rows.count(id) > 0) {
+        idx->prev_decay[id] = q.GetVal<int>("PrevDecayTime", i);
+      }
+    }
+
+    q = b->Query("Compositions", NULL);
+    for (int i = 0; i < q.rows.size(); ++i) {
+      int64_t qualid = GetId(q, "QualId", i);
+      if (qualids.count(qualid) > 0) {
+        int nucid = q.GetVal<int>("NucId", i);
+        idx->compmaps[qualid][nucid] = q.GetVal<double>("MassFrac", i);
+      }
+    }
+  }
+
+  if (products) {
+    QueryResult q = b->Query("Products", NULL);
+    for (int i = 0; i < q.rows.size(); ++i) {
+      int64_t qualid = GetId(q, "QualId", i);
+      if (qualids.count(qualid) > 0) {
+        idx->qualities[qualid] = q.GetVal<std::string>("Quality", i);
+      }
+    }
+  }
+}
+
+Resource::Ptr SimInit::LoadResource(Agent* creator, ResIndex* idx,
+                                    int64_t state_id) {
+  std::unordered_map<int64_t, int>::iterator row = idx->rows.find(state_id);
+  if (row == idx->rows.end()) {
+    throw IOError("Resource state missing from output database");
+  }
+  QueryResult& qr = idx->resources;
+  int i = row->second;
+  std::string type = qr.GetVal<std::string>("Type", i);
+  double qty = qr.GetVal<double>("Quantity", i);
+  int64_t qualid = GetId(qr, "QualId", i);
+
+  Resource::Ptr r;
+  if (type == Material::kType) {
+    Composition::Ptr& c = idx->comps[qualid];
+    if (!c) {
+      c = Composition::CreateFromMass(idx->compmaps[qualid]);
+      c->recorded_ = true;
+      c->id_ = qualid;
+    }
+    Material::Ptr mat = Material::Create(creator, qty, c);
+    mat->prev_decay_time_ = idx->prev_decay[state_id];
+    r = mat;
+  } else if (type == Product::kType) {
+    std::string quality = idx->qualities[qualid];
+    // set static quality-stateid map to have same vals as db
+    Product::qualids_[quality] = qualid;
+    r = Product::Create(creator, qty, quality);
+  } else {
+    throw IOError("Invalid resource type in output database: " + type);
+  }
+
+  r->state_id_ = state_id;
+  r->obj_id_ = GetId(qr, "ObjId", i);
+  return r;
+}
+
+Product::Ptr SimInit::LoadProduct(Context* ctx, QueryableBackend* b,
+                                  int64_t state_id) {
   // get general resource object info
   std::vector<Cond> conds;
-  conds.push_back(Cond("ResourceId", "==", state_id));
+  conds.push_back(IdCond(b, "Resources", "ResourceId", state_id));
   QueryResult qr = b->Query("Resources", &conds);
   double qty = qr.GetVal<double>("Quantity");
-  int stateid = qr.GetVal<int>("QualId");
+  int64_t stateid = GetId(qr, "QualId");
 
   // get special Product internal state
   conds.clear();
-  conds.push_back(Cond("QualId", "==", stateid));
+  conds.push_back(IdCond(b, "Products", "QualId", stateid));
   qr = b->Query("Products", &conds);
   std::string quality = qr.GetVal<std::string>("Quality");
 
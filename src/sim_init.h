@@ -1,6 +1,8 @@
 #ifndef CYCLUS_SRC_SIM_INIT_H_
 #define CYCLUS_SRC_SIM_INIT_H_
 
+#include <functional>
+
 #include <boost/uuid/uuid_io.hpp>
 
 #include "query_backend.h"
@@ -11,6 +13,7 @@
 namespace cyclus {
 
 class Context;
+class SnapDigest;
 
 /// Handles initialization of a simulation from the output database. After
 /// calling Init, Restart, or Branch, the initialized Context, Timer, and
@@ -44,8 +47,34 @@ class SimInit {
   void Branch(QueryableBackend* b, boost::uuids::uuid prev_sim_id, int t,
               boost::uuids::uuid new_sim_id);
 
+  /// Runs the simulation managed by ctx up to time t once and then forks n
+  /// worker processes that each continue it as a separate branch. In each
+  /// worker, the recorder's backends are replaced by the one returned by
+  /// back(i), which the worker owns, and the simulation gets a new id. The
+  /// new simulation records SimInfo::parent_sim, parent_type ("branch") and
+  /// branch_time. The recipes, prototypes, solver, living agents, pending
+  /// builds and decommissionings and the resources in inventories are
+  /// recorded again along with a snapshot at t, so that the branch's output
+  /// can be restarted from without the parent's.
+  ///
+  /// Returns the branch index i in the workers, which should then apply the
+  /// branch's overrides, call Timer::RunSim, close their recorder and
+  /// backend and leave with _exit, so that nothing inherited from the parent
+  /// process is flushed or destroyed twice. Returns -1 in the calling process
+  /// once all workers have exited.
+  ///
+  /// OpenMP runtimes are not fork-safe, so workers run every parallel region
+  /// with a single thread. Nothing in a worker may raise the thread count
+  /// again.
+  static int ForkBranches(Context* ctx, int t, int n,
+                          std::function<RecBackend*(int)> back);
+
   /// Records a snapshot of the current state of the simulation being managed by
-  /// ctx into the simulation's output database.
+  /// ctx into the simulation's output database. With
+  /// SimInfo::delta_snapshots, only agents whose state or inventories changed
+  /// since their last recorded snapshot are recorded. Every agent's snapshot
+  /// is still taken and hashed to find out whether it changed, so only the
+  /// output size follows simulation activity.
   static void Snapshot(Context* ctx);
 
   /// Records a snapshot of the agent's current internal state into the
@@ -68,12 +97,12 @@ class SimInit {
   /// Convenience function for reconstructing an untracked material object with
   /// the given resource state id from a database backend b.  Particularly
   /// useful for running mock simulations/tests.
-  static Material::Ptr BuildMaterial(QueryableBackend* b, int resid);
+  static Material::Ptr BuildMaterial(QueryableBackend* b, int64_t resid);
 
   /// Convenience function for reconstructing an untracked product object with
   /// the given resource state id from a database backend b.  Particularly
   /// useful for running mock simulations/tests.
-  static Product::Ptr BuildProduct(QueryableBackend* b, int resid);
+  static Product::Ptr BuildProduct(QueryableBackend* b, int64_t resid);
 
  private:
   void InitBase(QueryableBackend* b, boost::uuids::uuid simid, int t);
@@ -84,6 +113,7 @@ class SimInit {
   void LoadPrototypes();
   void LoadInitialAgents();
   void LoadInventories();
+  void LoadSnapTimes();
   void LoadBuildSched();
   void LoadDecomSched();
   void LoadNextIds();
@@ -91,14 +121,48 @@ class SimInit {
   void* LoadPreconditioner(std::string name);
   ExchangeSolver* LoadGreedySolver(bool exclusive, std::set<std::string> tables);
   ExchangeSolver* LoadCoinSolver(bool exclusive, std::set<std::string> tables);
-  static Resource::Ptr LoadResource(Context* ctx, QueryableBackend* b, int resid);
-  static Material::Ptr LoadMaterial(Context* ctx, QueryableBackend* b, int resid);
-  static Product::Ptr LoadProduct(Context* ctx, QueryableBackend* b, int resid);
-  static Composition::Ptr LoadComposition(QueryableBackend* b, int stateid);
+  static Resource::Ptr LoadResource(Context* ctx, QueryableBackend* b,
+                                    int64_t resid);
+  static Material::Ptr LoadMaterial(Context* ctx, QueryableBackend* b,
+                                    int64_t resid);
+  static Product::Ptr LoadProduct(Context* ctx, QueryableBackend* b,
+                                  int64_t resid);
+  static Composition::Ptr LoadComposition(QueryableBackend* b,
+                                          int64_t stateid);
+
+  /// Returns the time of the last snapshot recorded for the agent at or
+  /// before the restart time.
+  int SnapTime(int agentid);
+
+  /// Records everything besides a snapshot that a restart at the current
+  /// time needs from the output of ctx. Used for branches, whose output
+  /// starts in the middle of the simulation.
+  static void SnapSetup(Context* ctx);
+
+  /// Takes the agent's snapshot data and inventories by recording them to
+  /// rec, which hashes and keeps them in back. Returns false if the data has
+  /// types that cannot be hashed.
+  static bool AgentDigest(Agent* m, Recorder* rec, SnapDigest* back,
+                          Inventories* invs);
+
+  /// Records the resource state ids of the agent's inventories as part of
+  /// its snapshot.
+  static void SnapInventories(Agent* m, const Inventories& invs);
+
+  /// In-memory indexes over the resource tables for bulk loading.
+  struct ResIndex;
+  static void IndexResources(QueryableBackend* b, int t,
+                             const std::set<int64_t>& ids, ResIndex* idx);
+  static Resource::Ptr LoadResource(Agent* creator, ResIndex* idx,
+                                    int64_t state_id);
 
   // std::map<AgentId, Agent*>
   std::map<int, Agent*> agents_;
 
+  // std::map<AgentId, SimTime of the agent's last snapshot>, only filled for
+  // delta snapshots.
+  std::map<int, int> snap_times_;
+
   Context* ctx_;
   Recorder* rec_;
   Timer ti_;
@@ -267,6 +267,10 @@ void SqliteBack::Bind(boost::spirit::hold_any v, DbTypes type, SqlStatement::Ptr
     stmt->BindInt(index, v.cast<int>());
     break;
   }
+  case LONG: {
+    stmt->BindInt64(index, v.cast<int64_t>());
+    break;
+  }
   case BOOL: {
     stmt->BindInt(index, v.cast<bool>());
     break;
@@ -304,6 +308,8 @@ void SqliteBack::Bind(boost::spirit::hold_any v, DbTypes type, SqlStatement::Ptr
   CYCLUS_BINDVAL(MAP_INT_INT, std::map<int CYCLUS_COMMA int>);
   CYCLUS_BINDVAL(MAP_INT_STRING, std::map<int CYCLUS_COMMA std::string>);
   CYCLUS_BINDVAL(MAP_STRING_INT, std::map<std::string CYCLUS_COMMA int>);
+  CYCLUS_BINDVAL(MAP_INT_LONG, std::map<int CYCLUS_COMMA int64_t>);
+  CYCLUS_BINDVAL(MAP_STRING_LONG, std::map<std::string CYCLUS_COMMA int64_t>);
   CYCLUS_BINDVAL(MAP_STRING_DOUBLE, std::map<std::string CYCLUS_COMMA double>);
   CYCLUS_BINDVAL(MAP_STRING_STRING,
                  std::map<std::string CYCLUS_COMMA std::string>);
@@ -378,6 +384,9 @@ boost::spirit::hold_any SqliteBack::ColAsVal(SqlStatement::Ptr stmt,
   case INT: {
     v = stmt->GetInt(col);
     break;
+  } case LONG: {
+    v = stmt->GetInt64(col);
+    break;
   } case BOOL: {
     v = static_cast<bool>(stmt->GetInt(col));
     break;
@@ -413,6 +422,8 @@ boost::spirit::hold_any SqliteBack::ColAsVal(SqlStatement::Ptr stmt,
   CYCLUS_LOADVAL(MAP_INT_STRING, std::map<int CYCLUS_COMMA std::string>);
   CYCLUS_LOADVAL(MAP_STRING_DOUBLE, std::map<std::string CYCLUS_COMMA double>);
   CYCLUS_LOADVAL(MAP_STRING_INT, std::map<std::string CYCLUS_COMMA int>);
+  CYCLUS_LOADVAL(MAP_INT_LONG, std::map<int CYCLUS_COMMA int64_t>);
+  CYCLUS_LOADVAL(MAP_STRING_LONG, std::map<std::string CYCLUS_COMMA int64_t>);
   CYCLUS_LOADVAL(MAP_STRING_STRING,
                  std::map<std::string CYCLUS_COMMA std::string>);
   CYCLUS_LOADVAL(MAP_STRING_VECTOR_DOUBLE,
@@ -466,6 +477,7 @@ boost::spirit::hold_any SqliteBack::ColAsVal(SqlStatement::Ptr stmt,
 std::string SqliteBack::SqlType(boost::spirit::hold_any v) {
   switch (Type(v)) {
   case INT:  // fallthrough
+  case LONG:  // fallthrough
   case BOOL:
     return "INTEGER";
   case DOUBLE:  // fallthrough
@@ -491,6 +503,7 @@ static std::map<const std::type_info*, DbTypes, compare> type_map;
 DbTypes SqliteBack::Type(boost::spirit::hold_any v) {
   if (type_map.size() == 0) {
     type_map[&typeid(int)] = INT;
+    type_map[&typeid(int64_t)] = LONG;
     type_map[&typeid(double)] = DOUBLE;
     type_map[&typeid(float)] = FLOAT;
     type_map[&typeid(bool)] = BOOL;
@@ -508,6 +521,8 @@ DbTypes SqliteBack::Type(boost::spirit::hold_any v) {
     type_map[&typeid(std::map<int, double>)] = MAP_INT_DOUBLE;
     type_map[&typeid(std::map<int, std::string>)] = MAP_INT_STRING;
     type_map[&typeid(std::map<std::string, int>)] = MAP_STRING_INT;
+    type_map[&typeid(std::map<int, int64_t>)] = MAP_INT_LONG;
+    type_map[&typeid(std::map<std::string, int64_t>)] = MAP_STRING_LONG;
     type_map[&typeid(std::map<std::string, double>)] = MAP_STRING_DOUBLE;
     type_map[&typeid(std::map<std::string, std::string>)] = MAP_STRING_STRING;
     type_map[&typeid(std::map<std::string, std::vector<double> >)] =
@@ -36,6 +36,10 @@ int SqlStatement::GetInt(int col) {
   return sqlite3_column_int(stmt_, col);
 }
 
+int64_t SqlStatement::GetInt64(int col) {
+  return sqlite3_column_int64(stmt_, col);
+}
+
 double SqlStatement::GetDouble(int col) {
   return sqlite3_column_double(stmt_, col);
 }
@@ -53,6 +57,10 @@ void SqlStatement::BindInt(int i, int val) {
   Must(sqlite3_bind_int(stmt_, i, val));
 }
 
+void SqlStatement::BindInt64(int i, int64_t val) {
+  Must(sqlite3_bind_int64(stmt_, i, val));
+}
+
 void SqlStatement::BindDouble(int i, double val) {
   Must(sqlite3_bind_double(stmt_, i, val));
 }
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_SQLITE_DB_H_
 #define CYCLUS_SRC_SQLITE_DB_H_
 
+#include <stdint.h>
 #include <vector>
 #include <string>
 #include <boost/shared_ptr.hpp>
@@ -40,6 +41,10 @@ class SqlStatement {
   /// Returns an int value for the specified column of the current query row.
   int GetInt(int col);
 
+  /// Returns a 64-bit int value for the specified column of the current query
+  /// row.
+  int64_t GetInt64(int col);
+
   /// Returns a double value for the specified column of the current query row.
   double GetDouble(int col);
 
@@ -50,6 +55,9 @@ class SqlStatement {
   /// Binds the templated sql parameter at index i to val.
   void BindInt(int i, int val);
 
+  /// Binds the templated sql parameter at index i to val.
+  void BindInt64(int i, int64_t val);
+
   /// Binds the templated sql parameter at index i to val.
   void BindDouble(int i, double val);
 
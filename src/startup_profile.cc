@@ -0,0 +1,110 @@
+#include "startup_profile.h"
+
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "error.h"
+#include "pyne.h"
+
+namespace cyclus {
+
+bool StartupProfile::enabled_ = false;
+std::vector<StartupProfile::Phase> StartupProfile::phases_;
+std::vector<StartupProfile::Running> StartupProfile::running_;
+
+void StartupProfile::Begin(const std::string& name) {
+  Phase p;
+  p.name = name;
+  p.depth = running_.size();
+  p.secs = 0;
+  p.maxrss_kb = 0;
+  p.grew_kb = 0;
+  phases_.push_back(p);
+
+  Running r;
+  r.phase = phases_.size() - 1;
+  r.maxrss_kb = MaxRss();
+  r.start = std::chrono::steady_clock::now();
+  running_.push_back(r);
+}
+
+void StartupProfile::End() {
+  if (running_.empty()) {
+    throw StateError("no start-up phase is running");
+  }
+  Running r = running_.back();
+  running_.pop_back();
+
+  std::chrono::duration<double> took = std::chrono::steady_clock::now() -
+                                       r.start;
+  Phase& p = phases_[r.phase];
+  p.secs = took.count();
+  p.maxrss_kb = MaxRss();
+  p.grew_kb = p.maxrss_kb - r.maxrss_kb;
+}
+
+void StartupProfile::Clear() {
+  phases_.clear();
+  running_.clear();
+}
+
+long StartupProfile::MaxRss() {
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+std::string StartupProfile::ToTable() {
+  std::stringstream ss;
+  ss << std::left << std::setw(48) << "phase" << std::right
+     << std::setw(12) << "secs" << std::setw(14) << "maxrss (kB)"
+     << std::setw(14) << "grew (kB)" << "\n";
+  ss << std::fixed << std::setprecision(4);
+  for (int i = 0; i < phases_.size(); ++i) {
+    const Phase& p = phases_[i];
+    ss << std::left << std::setw(48) << std::string(2 * p.depth, ' ') + p.name
+       << std::right << std::setw(12) << p.secs << std::setw(14)
+       << p.maxrss_kb << std::setw(14) << p.grew_kb << "\n";
+  }
+  return ss.str();
+}
+
+std::string StartupProfile::ToJson() {
+  // the innermost open object for every depth, starting with the root
+  Json::Value root(Json::objectValue);
+  root["phases"] = Json::Value(Json::arrayValue);
+  std::vector<Json::Value*> parents(1, &root["phases"]);
+  for (int i = 0; i < phases_.size(); ++i) {
+    const Phase& p = phases_[i];
+    Json::Value v(Json::objectValue);
+    v["name"] = p.name;
+    v["secs"] = p.secs;
+    v["maxrss_kb"] = static_cast<Json::Int64>(p.maxrss_kb);
+    v["grew_kb"] = static_cast<Json::Int64>(p.grew_kb);
+    v["children"] = Json::Value(Json::arrayValue);
+
+    parents.resize(p.depth + 1);
+    Json::Value& added = parents.back()->append(v);
+    parents.push_back(&added["children"]);
+  }
+  root["maxrss_kb"] = static_cast<Json::Int64>(MaxRss());
+
+  Json::StyledWriter writer;
+  return writer.write(root);
+}
+
+}  // namespace cyclus
@@ -0,0 +1,93 @@
+#ifndef CYCLUS_SRC_STARTUP_PROFILE_H_
+#define CYCLUS_SRC_STARTUP_PROFILE_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace cyclus {
+
+/// Collects a hierarchical breakdown of the wall time and memory high-water
+/// mark of the phases of cyclus start-up (see the --profile-startup option of
+/// the cyclus CLI). Phases are marked with ProfileScope and nest in the
+/// order they are entered. Profiling is off unless enabled; while it is
+/// disabled, a ProfileScope does nothing.
+class StartupProfile {
+ public:
+  /// A finished or running phase.
+  struct Phase {
+    std::string name;
+    /// nesting level, 0 for top level phases
+    int depth;
+    /// wall time in seconds
+    double secs;
+    /// the process memory high-water mark at the end of the phase in kB
+    long maxrss_kb;
+    /// how much the phase raised the high-water mark in kB
+    long grew_kb;
+  };
+
+  static void Enable(bool on = true) { enabled_ = on; }
+
+  static bool enabled() { return enabled_; }
+
+  /// Starts a phase nested in the currently running one.
+  static void Begin(const std::string& name);
+
+  /// Ends the most recently started running phase.
+  static void End();
+
+  /// Returns all phases in the order they were started.
+  static const std::vector<Phase>& phases() { return phases_; }
+
+  /// Removes all recorded phases.
+  static void Clear();
+
+  /// Returns the phases as an indented text table.
+  static std::string ToTable();
+
+  /// Returns the phases as a JSON document. Its "phases" array holds the top
+  /// level phases as objects with the keys "name", "secs", "maxrss_kb",
+  /// "grew_kb" and "children" (the nested phases), and "maxrss_kb" holds the
+  /// current high-water mark.
+  static std::string ToJson();
+
+  /// Returns the current process memory high-water mark in kB, or 0 if it is
+  /// not available on this platform.
+  static long MaxRss();
+
+ private:
+  struct Running {
+    int phase;
+    std::chrono::steady_clock::time_point start;
+    long maxrss_kb;
+  };
+
+  static bool enabled_;
+  static std::vector<Phase> phases_;
+  static std::vector<Running> running_;
+};
+
+/// Profiles the enclosing scope as a start-up phase, if start-up profiling
+/// is enabled.
+class ProfileScope {
+ public:
+  ProfileScope(const std::string& name) : active_(StartupProfile::enabled()) {
+    if (active_) {
+      StartupProfile::Begin(name);
+    }
+  }
+
+  ~ProfileScope() {
+    if (active_) {
+      StartupProfile::End();
+    }
+  }
+
+ private:
+  bool active_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_STARTUP_PROFILE_H_
@@ -1,31 +1,63 @@
 // Implements the Timer class
 #include "timer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "agent.h"
 #include "error.h"
 #include "logger.h"
+#include "pool_alloc.h"
 #include "pyhooks.h"
+#include "res_lineage.h"
 #include "sim_init.h"
 
 
 namespace cyclus {
 
+/// Logs the allocation counters of the pooled resource types.
+static void LogPoolStats(LogLevel level) {
+  const PoolStats& m = pool_stats<Material>();
+  const PoolStats& p = pool_stats<Product>();
+  const PoolStats& c = pool_stats<Composition>();
+  MLOG(level) << "Material allocs=" << m.allocs << " live=" << m.live()
+              << " peak=" << m.peak;
+  MLOG(level) << "Product allocs=" << p.allocs << " live=" << p.live()
+              << " peak=" << p.peak;
+  MLOG(level) << "Composition allocs=" << c.allocs << " live=" << c.live()
+              << " peak=" << c.peak;
+}
+
 void Timer::RunSim() {
   CLOG(LEV_INFO1) << "Simulation set to run from start="
                   << 0 << " to end=" << si_.duration;
   CLOG(LEV_INFO1) << "Beginning simulation";
 
+  RunUntil(si_.duration);
+
+  ctx_->NewDatum("Finish")
+      ->AddVal("EarlyTerm", want_kill_)
+      ->AddVal("EndTime", time_-1)
+      ->Record();
+
+  SimInit::Snapshot(ctx_);  // always do a snapshot at the end of every simulation
+  LogPoolStats(LEV_INFO1);
+}
+
+void Timer::RunUntil(int t) {
   ExchangeManager<Material> matl_manager(ctx_);
   ExchangeManager<Product> genrsrc_manager(ctx_);
-  while (time_ < si_.duration) {
+  while (time_ < std::min(t, si_.duration)) {
     CLOG(LEV_INFO1) << "Current time: " << time_;
 
     if (want_snapshot_) {
       want_snapshot_ = false;
       SimInit::Snapshot(ctx_);
+    } else if (CheckpointDue()) {
+      Checkpoint();
     }
 
     // run through phases
@@ -42,19 +74,18 @@ void Timer::RunSim() {
     EventLoop();
 #endif
 
+    if (ctx_->lineage() != NULL) {
+      ctx_->lineage()->Flush();
+    }
+
+    RecordDecayStats();
+    LogPoolStats(LEV_DEBUG1);
     time_++;
 
     if (want_kill_) {
       break;
     }
   }
-
-  ctx_->NewDatum("Finish")
-      ->AddVal("EarlyTerm", want_kill_)
-      ->AddVal("EndTime", time_-1)
-      ->Record();
-
-  SimInit::Snapshot(ctx_);  // always do a snapshot at the end of every simulation
 }
 
 void Timer::DoBuild() {
@@ -96,43 +127,107 @@ void Timer::DoTock() {
   }
 
   if (si_.explicit_inventory || si_.explicit_inventory_compact) {
-    std::set<Agent*> ags = ctx_->agent_list_;
-    std::set<Agent*>::iterator it;
-    for (it = ags.begin(); it != ags.end(); ++it) {
-      Agent* a = *it;
-      if (a->enter_time() == -1) {
-        continue; // skip agents that aren't alive
-      }
-      RecordInventories(a);
-    }
+    RecordInventories();
   }
 }
 
+namespace {
+
+/// A material inventory of an agent, aggregated for recording.
+struct InvSum {
+  Agent* agent;
+  std::string name;
+  std::vector<Composition::Ptr> comps;
+  /// the time steps each composition is still to be decayed by
+  std::vector<int> deltas;
+  std::vector<double> qtys;
+  double qty;
+  CompMap mass;
+};
+
+}  // namespace
+
+void Timer::RecordInventories() {
+  // Collect the compositions of all inventories. Looking up (and lazily
+  // evaluating) compositions changes shared state, so it happens on this
+  // thread.
+  std::vector<InvSum> invs;
+  std::set<Agent*> ags = ctx_->agent_list_;
+  std::set<Agent*>::iterator it;
+  for (it = ags.begin(); it != ags.end(); ++it) {
+    Agent* a = *it;
+    if (a->enter_time() == -1) {
+      continue; // skip agents that aren't alive
+    }
+
+    Inventories snap = a->SnapshotInv();
+    Inventories::iterator it2;
+    for (it2 = snap.begin(); it2 != snap.end(); ++it2) {
+      std::vector<Resource::Ptr>& rs = it2->second;
+      if (rs.empty() || ResCast<Material>(rs[0]) == NULL) {
+        continue; // skip non-material inventories
+      }
 
-void Timer::RecordInventories(Agent* a) {
-  Inventories invs = a->SnapshotInv();
-  Inventories::iterator it2;
-  for (it2 = invs.begin(); it2 != invs.end(); ++it2) {
-    std::string name = it2->first;
-    std::vector<Resource::Ptr> mats = it2->second;
-    if (mats.empty() || ResCast<Material>(mats[0]) == NULL) {
-      continue; // skip non-material inventories
+      InvSum inv;
+      inv.agent = a;
+      inv.name = it2->first;
+      inv.qty = 0;
+      for (int i = 0; i < rs.size(); ++i) {
+        Material::Ptr m = ResCast<Material>(rs[i]);
+        int dt;
+        Composition::Ptr c = m->PeekComp(&dt);
+        if (dt > 0) {
+          Composition::Ptr decayed = c->FindDecay(dt);
+          if (decayed != NULL) {
+            c = decayed;
+            dt = 0;
+          }
+        }
+        // force evaluation of the compositions, which also looks up the
+        // masses of all their nuclides
+        c->atom();
+        c->mass();
+        inv.comps.push_back(c);
+        inv.deltas.push_back(dt);
+        inv.qtys.push_back(m->quantity());
+        inv.qty += m->quantity();
+      }
+      invs.push_back(inv);
     }
+  }
 
-    Material::Ptr m = ResCast<Material>(mats[0]->Clone());
-    for (int i = 1; i < mats.size(); i++) {
-      m->Absorb(ResCast<Material>(mats[i]->Clone()));
+  // sum the nuclide masses of the inventories, in parallel if OpenMP is
+  // available, each thread reusing its own buffer. Lazily decayed materials
+  // whose decay is not in a decay chain yet are decayed into a mass map
+  // only.
+  int n = invs.size();
+  #pragma omp parallel if (n > 1)
+  {
+    compmath::MassSum sum;
+    #pragma omp for schedule(dynamic)
+    for (int j = 0; j < n; ++j) {
+      for (int i = 0; i < invs[j].comps.size(); ++i) {
+        Composition::Ptr c = invs[j].comps[i];
+        if (invs[j].deltas[i] > 0) {
+          sum.Add(c->DecayMass(invs[j].deltas[i], si_.dt), invs[j].qtys[i]);
+        } else {
+          sum.Add(c->mass(), invs[j].qtys[i]);
+        }
+      }
+      sum.Take(&invs[j].mass);
     }
-    RecordInventory(a, name, m);
+  }
+
+  for (int j = 0; j < n; ++j) {
+    RecordInventory(invs[j].agent, invs[j].name, invs[j].qty, invs[j].mass);
   }
 }
 
-void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
+void Timer::RecordInventory(Agent* a, std::string name, double qty,
+                            const CompMap& mass) {
   if (si_.explicit_inventory) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, m->quantity());
-    CompMap::iterator it;
-    for (it = c.begin(); it != c.end(); ++it) {
+    CompMap::const_iterator it;
+    for (it = mass.begin(); it != mass.end(); ++it) {
       ctx_->NewDatum("ExplicitInventory")
           ->AddVal("AgentId", a->id())
           ->AddVal("Time", time_)
@@ -144,18 +239,34 @@ void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
   }
 
   if (si_.explicit_inventory_compact) {
-    CompMap c = m->comp()->mass();
+    CompMap c = mass;
     compmath::Normalize(&c, 1);
     ctx_->NewDatum("ExplicitInventoryCompact")
         ->AddVal("AgentId", a->id())
         ->AddVal("Time", time_)
         ->AddVal("InventoryName", name)
-        ->AddVal("Quantity", m->quantity())
+        ->AddVal("Quantity", qty)
         ->AddVal("Composition", c)
         ->Record();
   }
 }
 
+void Timer::RecordDecayStats() {
+  Composition::DecayStats& s = Composition::decay_stats();
+  int64_t n = s.hits + s.misses;
+  if (n == 0) {
+    return;
+  }
+
+  ctx_->NewDatum("DecayStats")
+      ->AddVal("Time", time_)
+      ->AddVal("Hits", s.hits)
+      ->AddVal("Misses", s.misses)
+      ->AddVal("HitRate", static_cast<double>(s.hits) / n)
+      ->Record();
+  s = Composition::DecayStats();
+}
+
 void Timer::DoDecom() {
   // decommission queued agents
   std::vector<Agent*> decom_list = decom_queue_[time_];
@@ -238,12 +349,61 @@ void Timer::Initialize(Context* ctx, SimInfo si) {
   if (si.branch_time > -1) {
     time_ = si.branch_time;
   }
+  last_checkpoint_ = time_;
+  last_checkpoint_wall_ = std::chrono::steady_clock::now();
+  checkpoint_stretch_ = 1;
+}
+
+bool Timer::CheckpointDue() {
+  double interval = si_.checkpoint_interval * checkpoint_stretch_;
+  if (si_.checkpoint_interval > 0 && time_ - last_checkpoint_ >= interval) {
+    return true;
+  }
+  if (si_.checkpoint_wall > 0) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - last_checkpoint_wall_;
+    return elapsed.count() >= si_.checkpoint_wall * checkpoint_stretch_;
+  }
+  return false;
+}
+
+void Timer::Checkpoint() {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  SimInit::Snapshot(ctx_);
+  ctx_->rec_->Flush();
+
+  last_checkpoint_ = time_;
+  last_checkpoint_wall_ = std::chrono::steady_clock::now();
+  std::chrono::duration<double> took = last_checkpoint_wall_ - start;
+  CLOG(LEV_INFO2) << "Checkpoint for time " << time_ << " took "
+                  << took.count() << " s";
+
+  // a checkpoint cannot be cut short, so the share of time spent in
+  // checkpoints is kept down by checkpointing less often after slow ones.
+  double backoff = si_.checkpoint_backoff;
+  if (backoff > 0 && took.count() > backoff) {
+    checkpoint_stretch_ = std::ceil(checkpoint_stretch_ * took.count() /
+                                    backoff);
+    std::stringstream ss;
+    ss << "checkpoint at time " << time_ << " took " << took.count()
+       << " s, more than the backoff threshold of " << backoff
+       << " s; checkpoint intervals are now " << checkpoint_stretch_
+       << " times longer";
+    Warn<VALUE_WARNING>(ss.str());
+  }
 }
 
 int Timer::dur() {
   return si_.duration;
 }
 
-Timer::Timer() : time_(0), si_(0), want_snapshot_(false), want_kill_(false) {}
+Timer::Timer()
+    : time_(0),
+      si_(0),
+      want_snapshot_(false),
+      want_kill_(false),
+      last_checkpoint_(0),
+      checkpoint_stretch_(1) {}
 
 }  // namespace cyclus
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_TIMER_H_
 #define CYCLUS_SRC_TIMER_H_
 
+#include <chrono>
 #include <utility>
 #include <vector>
 
@@ -21,6 +22,7 @@ class Agent;
 /// Controls simulation timestepping and inter-timestep phases.
 class Timer {
   friend class ::SimInitTest;
+  friend class SimInit;
  public:
   Timer();
 
@@ -35,6 +37,10 @@ class Timer {
   /// Runs the simulation.
   void RunSim();
 
+  /// Runs the simulation time steps up to, but not including, time t without
+  /// finishing the simulation. A later call to RunSim continues from t.
+  void RunUntil(int t);
+
   /// Registers an agent to receive tick/tock notifications every timestep.
   /// Agents should register from their Deploy method.
   void RegisterTimeListener(TimeListener* agent);
@@ -85,12 +91,32 @@ class Timer {
   /// notifications.
   void DoTock();
 
-  void RecordInventories(Agent* a);
-  void RecordInventory(Agent* a, std::string name, Material::Ptr m);
+  /// Records the material inventories of all live agents in the
+  /// ExplicitInventory and/or ExplicitInventoryCompact tables.
+  void RecordInventories();
+
+  /// Records one inventory, where mass holds the total mass of each nuclide
+  /// (kg) and qty the total mass of the inventory.
+  void RecordInventory(Agent* a, std::string name, double qty,
+                       const CompMap& mass);
 
   /// decommissions all agents queued for the current timestep.
   void DoDecom();
 
+  /// Records the decay cache counters of the current time step in the
+  /// DecayStats table, if any decays were asked for, and resets them.
+  void RecordDecayStats();
+
+  /// Returns true if an automatic checkpoint is due at the current time step
+  /// (see SimInfo::checkpoint_interval and SimInfo::checkpoint_wall).
+  bool CheckpointDue();
+
+  /// Snapshots the simulation and flushes the recorder, so that the
+  /// simulation can be restarted from the current time step. A checkpoint
+  /// that takes longer than SimInfo::checkpoint_backoff stretches the
+  /// checkpoint intervals, so that checkpoints become less frequent.
+  void Checkpoint();
+
   Context* ctx_;
 
   /// The current time, measured in months from when the simulation
@@ -102,6 +128,13 @@ class Timer {
   bool want_snapshot_;
   bool want_kill_;
 
+  /// time step and wall-clock time of the last checkpoint
+  int last_checkpoint_;
+  std::chrono::steady_clock::time_point last_checkpoint_wall_;
+
+  /// factor the checkpoint intervals are stretched by after slow checkpoints
+  double checkpoint_stretch_;
+
   /// Concrete agents that desire to receive tick and tock notifications
   std::map<int, TimeListener*> tickers_;
 
@@ -68,9 +68,16 @@ void CommodityRecipeContext::InitFrom(QueryableBackend* b) {
     qr = b->Query("CommodityRecipeContext_resmap", NULL);
   } catch(std::exception err) { return; }  // Table doesn't exist (okay)
 
+  // older databases store the resource ids as INT
+  bool old_ids = false;
+  for (int i = 0; i < qr.fields.size(); ++i) {
+    old_ids = old_ids || (qr.fields[i] == "res_id" && qr.types[i] == INT);
+  }
+
   for (int i = 0; i < qr.rows.size(); ++i) {
     std::string commod = qr.GetVal<std::string>("commod", i);
-    int id = qr.GetVal<int>("res_id", i);
+    int64_t id = old_ids ? qr.GetVal<int>("res_id", i) :
+                 qr.GetVal<int64_t>("res_id", i);
     rsrc_commod_map_[id] = commod;
   }
 }
@@ -87,7 +94,7 @@ void CommodityRecipeContext::Snapshot(DbInit di) {
       ->Record();
   }
 
-  std::map<int, std::string>::iterator it = rsrc_commod_map_.begin();
+  std::map<int64_t, std::string>::iterator it = rsrc_commod_map_.begin();
   for (; it != rsrc_commod_map_.end(); ++it) {
     di.NewDatum("CommodityRecipeContext_resmap")
         ->AddVal("commod", it->second)
@@ -92,7 +92,7 @@ class CommodityRecipeContext : public StateWrangler {
   std::map<std::string, std::string> out_commod_map_;
   std::map<std::string, std::string> in_recipes_;
   std::map<std::string, std::string> out_recipes_;
-  std::map<int, std::string> rsrc_commod_map_;
+  std::map<int64_t, std::string> rsrc_commod_map_;
 };
 
 }  // namespace toolkit
@@ -1,10 +1,10 @@
 #ifndef CYCLUS_SRC_TOOLKIT_RES_BUF_H_
 #define CYCLUS_SRC_TOOLKIT_RES_BUF_H_
 
+#include <functional>
 #include <iomanip>
 #include <limits>
-#include <list>
-#include <set>
+#include <unordered_set>
 #include <vector>
 
 #include "cyc_arithmetic.h"
@@ -27,6 +27,8 @@ typedef std::vector<Product::Ptr> ProdVec;
 /// Constructed buffers have infinite capacity unless explicitly changed.
 /// Resource popping occurs in the order the resources were pushed (i.e. oldest
 /// resources are popped first), unless explicitly specified otherwise.
+/// Resources are stored in a contiguous ring buffer, so pushing and popping
+/// at either end is O(1) amortized.
 ///
 /// Typically, a ResBuf will be a member variable on an agent/archetype class.
 /// Resources can be added and retrieved from it as needed, and the buffer can
@@ -61,7 +63,7 @@ typedef std::vector<Product::Ptr> ProdVec;
 template <class T>
 class ResBuf {
  public:
-  ResBuf() : cap_(INFINITY), qty_(0) { }
+  ResBuf() : cap_(INFINITY), qty_(0), head_(0), n_(0) { }
 
   virtual ~ResBuf() {}
 
@@ -87,7 +89,7 @@ class ResBuf {
 
   /// Returns the total number of constituent resource objects
   /// in the buffer. Never throws.
-  inline int count() const { return rs_.size(); }
+  inline int count() const { return n_; }
 
   /// Returns the total resource quantity of constituent resource
   /// objects in the buffer. Never throws.
@@ -99,7 +101,7 @@ class ResBuf {
   inline double space() const { return std::max(0.0, cap_ - qty_); }
 
   /// Returns true if there are no resources in the buffer.
-  inline bool empty() const { return rs_.empty(); }
+  inline bool empty() const { return n_ == 0; }
 
   /// Pops and returns the specified quantity from the buffer as a single
   /// resource object.
@@ -118,27 +120,21 @@ class ResBuf {
       throw ValueError(ss.str());
     }
 
-    std::vector<typename T::Ptr> rs;
-    typename T::Ptr r;
-    typename T::Ptr tmp;
+    // find the whole resources to pop first so they are removed in one batch
     double left = qty;
-    double quan;
-    while (left > 0 && count() > 0) {
-      r = rs_.front();
-      rs_.pop_front();
-      quan = r->quantity();
-      if (quan > left) {
-        // too big - split the res before popping
-        tmp = boost::dynamic_pointer_cast<T>(r->ExtractRes(left));
-        rs_.push_front(r);
-        r = tmp;
-      } else {
-        rs_present_.erase(r);
-      }
+    int n = 0;
+    while (n < n_ && left > 0 && at(n)->quantity() <= left) {
+      left -= at(n)->quantity();
+      n++;
+    }
 
+    std::vector<typename T::Ptr> rs = PopFront(n);
+    if (left > 0 && n_ > 0) {
+      // too big - split the res, which stays at the front of the buffer
+      typename T::Ptr r = boost::dynamic_pointer_cast<T>(
+          at(0)->ExtractRes(left));
       qty_ -= r->quantity();
       rs.push_back(r);
-      left -= quan;
     }
 
     UpdateQty();
@@ -176,15 +172,7 @@ class ResBuf {
       throw ValueError(ss.str());
     }
 
-    std::vector<typename T::Ptr> rs;
-    for (int i = 0; i < n; i++) {
-      typename T::Ptr r = rs_.front();
-      qty_ -= r->quantity();
-      rs_.pop_front();
-      rs.push_back(r);
-      rs_present_.erase(r);
-    }
-
+    std::vector<typename T::Ptr> rs = PopFront(n);
     UpdateQty();
     return rs;
   }
@@ -195,10 +183,10 @@ class ResBuf {
   /// Returns the next resource in line to be popped from the buffer
   /// without actually removing it from the buffer.
   typename T::Ptr Peek() {
-    if (rs_.size() < 1) {
+    if (n_ < 1) {
       throw ValueError("cannot peek at resource from an empty buff");
     }
-    return rs_.front();
+    return at(0);
   }
 
   /// Pops one resource object from the buffer.
@@ -207,26 +195,24 @@ class ResBuf {
   ///
   /// @throws ValueError the buffer is empty.
   typename T::Ptr Pop() {
-    if (rs_.size() < 1) {
+    if (n_ < 1) {
       throw ValueError("cannot pop resource from an empty buff");
     }
 
-    typename T::Ptr r = rs_.front();
-    rs_.pop_front();
-    rs_present_.erase(r);
-    qty_ -= r->quantity();
+    typename T::Ptr r = PopFront(1)[0];
     UpdateQty();
     return r;
   }
 
   /// Same as Pop, except it returns the most recently added resource.
   typename T::Ptr PopBack() {
-    if (rs_.size() < 1) {
+    if (n_ < 1) {
       throw ValueError("cannot pop resource from an empty buff");
     }
 
-    typename T::Ptr r = rs_.back();
-    rs_.pop_back();
+    typename T::Ptr r;
+    r.swap(at(n_ - 1));
+    n_--;
     rs_present_.erase(r);
     qty_ -= r->quantity();
     UpdateQty();
@@ -256,8 +242,7 @@ class ResBuf {
       throw KeyError("duplicate resource push attempted");
     }
 
-    rs_.push_back(m);
-    rs_present_.insert(m);
+    PushBack(m);
     qty_ += r->quantity();
     UpdateQty();
   }
@@ -299,20 +284,82 @@ class ResBuf {
       }
     }
 
+    Reserve(n_ + static_cast<int>(rss.size()));
     for (int i = 0; i < rss.size(); i++) {
-      rs_.push_back(rss[i]);
-      rs_present_.insert(rss[i]);
+      PushBack(rss[i]);
     }
     qty_ += tot_qty;
   }
 
+  /// Decays all materials in the buffer up to curr_time in a single bulk
+  /// operation (see Material::Decay(const std::vector<Material::Ptr>&, int)).
+  /// Only available for ResBuf<Material>.
+  void Decay(int curr_time = -1) {
+    std::vector<Material::Ptr> mats;
+    mats.reserve(n_);
+    for (int i = 0; i < n_; ++i) {
+      mats.push_back(at(i));
+    }
+    Material::Decay(mats, curr_time);
+  }
+
  private:
+  /// Hashes resource pointers by address.
+  struct PtrHash {
+    std::size_t operator()(const typename T::Ptr& p) const {
+      return std::hash<T*>()(p.get());
+    }
+  };
+
+  /// Returns the i-th resource from the front of the buffer.
+  inline typename T::Ptr& at(int i) {
+    return rs_[(head_ + i) & (rs_.size() - 1)];
+  }
+
+  /// Grows the ring storage, if needed, to hold at least n resources.
+  void Reserve(int n) {
+    if (n <= static_cast<int>(rs_.size())) {
+      return;
+    }
+
+    int size = rs_.empty() ? 8 : rs_.size();
+    while (size < n) {
+      size *= 2;
+    }
+
+    std::vector<typename T::Ptr> rs(size);
+    for (int i = 0; i < n_; i++) {
+      rs[i].swap(at(i));
+    }
+    rs_.swap(rs);
+    head_ = 0;
+  }
+
+  void PushBack(typename T::Ptr r) {
+    Reserve(n_ + 1);
+    rs_present_.insert(r);
+    at(n_) = r;
+    n_++;
+  }
+
+  /// Removes the n oldest resources from the buffer and returns them.
+  std::vector<typename T::Ptr> PopFront(int n) {
+    std::vector<typename T::Ptr> rs(n);
+    for (int i = 0; i < n; i++) {
+      rs[i].swap(at(i));
+      rs_present_.erase(rs[i]);
+      qty_ -= rs[i]->quantity();
+    }
+    head_ = (head_ + n) & (rs_.size() - 1);
+    n_ -= n;
+    return rs;
+  }
+
   void UpdateQty() {
-    int n = rs_.size();
-    if (n == 0) {
+    if (n_ == 0) {
       qty_ = 0;
-    } else if (n == 1) {
-      qty_ = rs_.front()->quantity();
+    } else if (n_ == 1) {
+      qty_ = at(0)->quantity();
     }
   }
 
@@ -321,9 +368,17 @@ class ResBuf {
   /// Maximum quantity of resources this buffer can hold
   double cap_;
 
-  /// List of constituent resource objects forming the buffer's inventory
-  std::list<typename T::Ptr> rs_;
-  std::set<typename T::Ptr> rs_present_;
+  /// Ring buffer of constituent resource objects forming the buffer's
+  /// inventory. Its size is always zero or a power of two.
+  std::vector<typename T::Ptr> rs_;
+
+  /// index in rs_ of the oldest resource
+  int head_;
+
+  /// number of resources in the buffer
+  int n_;
+
+  std::unordered_set<typename T::Ptr, PtrHash> rs_present_;
 };
 
 }  // namespace toolkit
@@ -22,9 +22,7 @@ Material::Ptr Squash(std::vector<Material::Ptr> ms) {
   }
 
   Material::Ptr m = ms[0];
-  for (int i = 1; i < ms.size(); ++i) {
-    m->Absorb(ms[i]);
-  }
+  m->Absorb(std::vector<Material::Ptr>(ms.begin() + 1, ms.end()));
   return m;
 }
 
@@ -2,7 +2,6 @@
 #define CYCLUS_SRC_TOOLKIT_RES_MAP_H_
 
 #include <iomanip>
-#include <limits>
 #include <map>
 #include <set>
 #include <vector>
@@ -51,9 +50,9 @@ class ResMap {
   typedef typename std::map<K, typename R::Ptr>::iterator iterator;
   typedef typename std::map<K, typename R::Ptr>::const_iterator const_iterator;
 
-  typedef typename std::map<K, int> obj_type;
-  typedef typename std::map<K, int>::iterator obj_iterator;
-  typedef typename std::map<K, int>::const_iterator const_obj_iterator;
+  typedef typename std::map<K, int64_t> obj_type;
+  typedef typename std::map<K, int64_t>::iterator obj_iterator;
+  typedef typename std::map<K, int64_t>::const_iterator const_obj_iterator;
 
   //
   // properties
@@ -69,12 +68,12 @@ class ResMap {
     return quantity_;
   };
 
+  /// Returns the object ids of the resources by key.
   obj_type& obj_ids() {
     obj_ids_.clear();
     iterator it = resources_.begin();
-    for (; it != resources_.end(); ++it) {
+    for (; it != resources_.end(); ++it)
       obj_ids_[it->first] = it->second->obj_id();
-    }
     return obj_ids_;
   }
 
@@ -177,7 +176,7 @@ class ResMap {
   /// member must be set.  This is primarily for restart capabilities and is
   /// not recomended for day-to-day use.
   void Values(std::vector<typename R::Ptr> vals) {
-    std::map<int, K> lookup;
+    std::map<int64_t, K> lookup;
     obj_iterator oit = obj_ids_.begin();
     for (; oit != obj_ids_.end(); ++oit) {
       lookup[oit->second] = oit->first;
@@ -211,6 +210,13 @@ class ResMap {
     return val;
   }
 
+  /// Decays all materials in the map up to curr_time in a single bulk
+  /// operation (see Material::Decay(const std::vector<Material::Ptr>&, int)).
+  /// Only available for ResMap<K, Material>.
+  void Decay(int curr_time = -1) {
+    Material::Decay(Values(), curr_time);
+  }
+
  private:
   /// Recomputes the internal quantity variable.
   void UpdateQuantity() {
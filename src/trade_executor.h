@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "context.h"
+#include "res_lineage.h"
 #include "trade.h"
 #include "trader.h"
 #include "trader_management.h"
@@ -89,6 +90,9 @@ class TradeExecutor {
       for (v_it = trades.begin(); v_it != trades.end(); ++v_it) {
         Trade<T>& trade = v_it->first;
         typename T::Ptr rsrc =  v_it->second;
+        if (ctx->lineage() != NULL) {
+          ctx->lineage()->Pin(rsrc->state_id());
+        }
         ctx->NewDatum("Transactions")
             ->AddVal("TransactionId", ctx->NextTransactionID())
             ->AddVal("SenderId", supplier->id())
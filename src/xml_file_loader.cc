@@ -2,9 +2,12 @@
 #include "xml_file_loader.h"
 
 #include <algorithm>
+#include <ctime>
 #include <fstream>
+#include <iomanip>
 #include <set>
 #include <streambuf>
+#include <typeinfo>
 
 #include <boost/filesystem.hpp>
 #include <libxml++/libxml++.h>
@@ -19,9 +22,13 @@
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
 #include "infile_tree.h"
+#include "json_infile_tree.h"
 #include "logger.h"
+#include "pyhooks.h"
 #include "sim_init.h"
+#include "startup_profile.h"
 #include "toolkit/infile_converters.h"
+#include "version.h"
 
 namespace cyclus {
 
@@ -54,6 +61,27 @@ void LoadStringstreamFromFile(std::stringstream& stream, std::string file, std::
   }
 }
 
+bool LoadJsonFromFile(std::string& json, std::string file,
+                      std::string format) {
+  std::string inext;
+  if (format == "none") {
+    inext = fs::path(file).extension().string();
+  }
+  bool py = inext == ".py" || format == "py";
+  if (!py && inext != ".json" && format != "json") {
+    return false;
+  }
+
+  std::stringstream input;
+  if (format == "none") {
+    LoadRawStringstreamFromFile(input, file);
+  } else {
+    input << file;
+  }
+  json = py ? toolkit::PyToJson(input.str()) : input.str();
+  return true;
+}
+
 std::string LoadStringFromFile(std::string file, std::string format) {
   std::stringstream input;
   LoadStringstreamFromFile(input, file, format);
@@ -66,14 +94,17 @@ std::vector<AgentSpec> ParseSpecs(std::string infile, std::string format) {
   XMLParser parser_;
   parser_.Init(input);
   InfileTree xqe(parser_);
+  return ParseSpecs(&xqe);
+}
 
+std::vector<AgentSpec> ParseSpecs(InfileTree* tree) {
   std::vector<AgentSpec> specs;
   std::set<std::string> unique;
 
   std::string p = "/simulation/archetypes/spec";
-  int n = xqe.NMatches(p);
+  int n = tree->NMatches(p);
   for (int i = 0; i < n; ++i) {
-    AgentSpec spec(xqe.SubTree(p, i));
+    AgentSpec spec(tree->SubTree(p, i));
     if (unique.count(spec.str()) == 0) {
       specs.push_back(spec);
       unique.insert(spec.str());
@@ -88,6 +119,11 @@ std::vector<AgentSpec> ParseSpecs(std::string infile, std::string format) {
 }
 
 std::string BuildMasterSchema(std::string schema_path, std::string infile, std::string format) {
+  return BuildMasterSchema(schema_path, ParseSpecs(infile, format));
+}
+
+std::string BuildMasterSchema(std::string schema_path,
+                              std::vector<AgentSpec> specs) {
   Timer ti;
   Recorder rec;
   Context ctx(&ti, &rec);
@@ -96,8 +132,6 @@ std::string BuildMasterSchema(std::string schema_path, std::string infile, std::
   LoadStringstreamFromFile(schema, schema_path);
   std::string master = schema.str();
 
-  std::vector<AgentSpec> specs = ParseSpecs(infile, format);
-
   std::map<std::string, std::string> subschemas;
 
   // force element types to exist so we always replace the config string
@@ -162,16 +196,28 @@ XMLFileLoader::XMLFileLoader(Recorder* r,
                              std::string schema_file,
                              const std::string input_file,
                              const std::string format, bool ms_print) : b_(b), rec_(r) {
+  ProfileScope prof("read input");
   ctx_ = new Context(&ti_, rec_);
 
   schema_path_ = schema_file;
   file_ = input_file;
   format_ = format;
+  ms_print_ = ms_print;
+  if (LoadJsonFromFile(json_, file_, format)) {
+    // queries skip the round trip through an xml document, but the input is
+    // still recorded as xml
+    tree_ = boost::shared_ptr<InfileTree>(new JsonInfileTree(json_));
+    ctx_->NewDatum("InputFiles")
+        ->AddVal("Data", Blob(toolkit::JsonToXml(json_)))
+        ->Record();
+    return;
+  }
+
   std::stringstream input;
   LoadStringstreamFromFile(input, file_, format);
   parser_ = boost::shared_ptr<XMLParser>(new XMLParser());
   parser_->Init(input);
-  ms_print_ = ms_print;
+  tree_ = boost::shared_ptr<InfileTree>(new InfileTree(*parser_));
   std::stringstream ss;
   parser_->Document()->write_to_stream_formatted(ss);
   ctx_->NewDatum("InputFiles")
@@ -184,27 +230,154 @@ XMLFileLoader::~XMLFileLoader() {
 }
 
 std::string XMLFileLoader::master_schema() {
-  return BuildMasterSchema(schema_path_, file_, format_);
+  return BuildMasterSchema(schema_path_, ParseSpecs(tree_.get()));
 }
 
 void XMLFileLoader::LoadSim() {
-  std::stringstream ss(master_schema());
+  ProfileScope prof("LoadSim");
   if(ms_print_){
     std::cout << master_schema() << std::endl;
   }
-  parser_->Validate(ss);
-  LoadControlParams();  // must be first
-  LoadSolver();
-  LoadRecipes();
-  LoadSpecs();
-  LoadInitialAgents();  // must be last
+  {
+    ProfileScope p("ValidateInput");
+    ValidateInput();
+  }
+  {
+    ProfileScope p("load control, solver, recipes and specs");
+    LoadControlParams();  // must be first
+    LoadSolver();
+    LoadRecipes();
+    LoadSpecs();
+  }
+  {
+    ProfileScope p("LoadInitialAgents");
+    LoadInitialAgents();  // must be last
+  }
+  ProfileScope p("snapshot and flush");
   SimInit::Snapshot(ctx_);
   rec_->Flush();
 }
 
+/// Returns the hex form of d.
+static std::string DigestHex(const Digest& d) {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (int i = 0; i < CYCLUS_SHA1_NINT; ++i) {
+    ss << std::setw(8) << d.val[i];
+  }
+  return ss.str();
+}
+
+/// Returns a digest of the kind and schema of the archetype spec. Schemas can
+/// be expensive to generate, so the digest is kept in the input cache by the
+/// archetype's library file and its modification time. Archetypes that are
+/// not loaded from a file always have their schema generated.
+static std::string SchemaDigest(Context* ctx, AgentSpec spec) {
+  Agent* m = DynamicModule::Make(ctx, spec);
+  std::string lib = DynamicModule::LibraryFile(spec);
+  fs::path entry;
+  if (lib != "") {
+    boost::system::error_code err;
+    std::time_t mtime = fs::last_write_time(lib, err);
+    if (!err) {
+      std::stringstream ss;
+      ss << spec.str() << "\n" << fs::absolute(lib).string() << "\n" << mtime;
+      Sha1 key;
+      key.Update(ss.str());
+      entry = fs::path(Env::input_cache()) / "schemas" /
+              DigestHex(key.digest());
+    }
+  }
+
+  std::string digest;
+  if (!entry.empty()) {
+    std::ifstream f(entry.string().c_str());
+    std::getline(f, digest);  // stays empty if not cached yet
+  }
+  if (digest.empty()) {
+    Sha1 hash;
+    hash.Update(m->kind());
+    hash.Update(m->schema());
+    digest = DigestHex(hash.digest());
+
+    // the cache is best effort, failing to write it is not an error
+    if (!entry.empty()) {
+      boost::system::error_code err;
+      fs::create_directories(entry.parent_path(), err);
+      std::ofstream f(entry.string().c_str());
+      f << digest << "\n";
+    }
+  }
+  ctx->DelAgent(m);
+  return digest;
+}
+
+std::string XMLFileLoader::InputCacheKey() {
+  std::stringstream doc;
+  if (parser_) {
+    parser_->Document()->write_to_stream(doc);
+  } else {
+    doc << json_;
+  }
+  std::stringstream schema;
+  LoadStringstreamFromFile(schema, schema_path_);
+
+  Sha1 hash;
+  hash.Update(std::string(version::core()));
+  hash.Update(std::string(typeid(*this).name()));
+  hash.Update(schema.str());
+
+  Timer ti;
+  Recorder rec;
+  Context ctx(&ti, &rec);
+  std::vector<AgentSpec> specs = ParseSpecs(tree_.get());
+  for (int i = 0; i < specs.size(); ++i) {
+    hash.Update(specs[i].str());
+    hash.Update(specs[i].alias());
+    hash.Update(SchemaDigest(&ctx, specs[i]));
+  }
+  hash.Update(doc.str());
+  return DigestHex(hash.digest());
+}
+
+void XMLFileLoader::ValidateInput() {
+  fs::path marker;
+  std::string cache = Env::input_cache();
+  if (cache != "") {
+    std::string key = InputCacheKey();
+    marker = fs::path(cache) / (key + ".valid");
+    if (fs::exists(marker)) {
+      CLOG(LEV_INFO2) << "Skipping validation of already validated input "
+                      << key;
+      return;
+    }
+  }
+
+  std::string master;
+  {
+    ProfileScope p("master schema");
+    master = master_schema();
+  }
+  if (!parser_) {
+    // RelaxNG validation needs the xml form of the input
+    std::stringstream input(toolkit::JsonToXml(json_));
+    parser_ = boost::shared_ptr<XMLParser>(new XMLParser());
+    parser_->Init(input);
+  }
+  std::stringstream ss(master);
+  parser_->Validate(ss);
+
+  // the cache is best effort, failing to write it is not an error
+  if (!marker.empty()) {
+    boost::system::error_code err;
+    fs::create_directories(marker.parent_path(), err);
+    std::ofstream f(marker.string().c_str());
+  }
+}
+
 void XMLFileLoader::LoadSolver() {
   using std::string;
-  InfileTree xqe(*parser_);
+  InfileTree& xqe = *tree_;
   InfileTree* qe;
   std::string query = "/*/commodity";
 
@@ -312,7 +485,7 @@ void XMLFileLoader::ProcessCommodities(
 }
 
 void XMLFileLoader::LoadRecipes() {
-  InfileTree xqe(*parser_);
+  InfileTree& xqe = *tree_;
 
   std::string query = "/*/recipe";
   int num_recipes = xqe.NMatches(query);
@@ -327,7 +500,7 @@ void XMLFileLoader::LoadRecipes() {
 }
 
 void XMLFileLoader::LoadSpecs() {
-  std::vector<AgentSpec> specs = ParseSpecs(file_, format_);
+  std::vector<AgentSpec> specs = ParseSpecs(tree_.get());
   for (int i = 0; i < specs.size(); ++i) {
     specs_[specs[i].alias()] = specs[i];
   }
@@ -339,41 +512,14 @@ void XMLFileLoader::LoadInitialAgents() {
   schema_paths["Inst"] = "/*/region/institution";
   schema_paths["Facility"] = "/*/facility";
 
-  InfileTree xqe(*parser_);
+  InfileTree& xqe = *tree_;
 
   // create prototypes
-  std::string prototype;  // defined here for force-create AgentExit tbl
   std::map<std::string, std::string>::iterator it;
   for (it = schema_paths.begin(); it != schema_paths.end(); it++) {
     int num_agents = xqe.NMatches(it->second);
     for (int i = 0; i < num_agents; i++) {
-      InfileTree* qe = xqe.SubTree(it->second, i);
-      prototype = qe->GetString("name");
-      std::string alias = qe->SubTree("config")->GetElementName(0);
-      AgentSpec spec = specs_[alias];
-
-      Agent* agent = DynamicModule::Make(ctx_, spec);
-
-      // call manually without agent impl injected to keep all Agent state in a
-      // single, consolidated db table
-      agent->Agent::InfileToDb(qe, DbInit(agent, true));
-
-      agent->InfileToDb(qe, DbInit(agent));
-      rec_->Flush();
-
-      std::vector<Cond> conds;
-      conds.push_back(Cond("SimId", "==", rec_->sim_id()));
-      conds.push_back(Cond("SimTime", "==", static_cast<int>(0)));
-      conds.push_back(Cond("AgentId", "==", agent->id()));
-      CondInjector ci(b_, conds);
-      PrefixInjector pi(&ci, "AgentState");
-
-      // call manually without agent impl injected
-      agent->Agent::InitFrom(&pi);
-
-      pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
-      agent->InitFrom(&pi);
-      ctx_->AddPrototype(prototype, agent);
+      LoadPrototype(xqe.SubTree(it->second, i));
     }
   }
 
@@ -404,6 +550,80 @@ void XMLFileLoader::LoadInitialAgents() {
   }
 }
 
+/// Hashes the names and text of all elements below tree. Elements without
+/// plain text content add only their name, which is enough because any such
+/// element read by an agent fails to load on the first prototype using it.
+static void HashTree(InfileTree* tree, Sha1* hash) {
+  // children are looked up by name and position among their namesakes,
+  // which the tree answers from its index rather than by evaluating a "*"
+  // query per child
+  std::map<std::string, int> seen;
+  int n = tree->NElements();
+  for (int i = 0; i < n; ++i) {
+    std::string name = tree->GetElementName(i);
+    hash->Update("<" + name + ">");
+    InfileTree* sub = tree->SubTree(name, seen[name]++);
+    if (sub->NElements() > 0) {
+      HashTree(sub, hash);
+    } else {
+      try {
+        hash->Update(sub->GetString("."));
+      } catch (ValueError& e) {
+        // no text
+      }
+    }
+    hash->Update(std::string("</>"));
+    tree->ReleaseSubTree(sub);
+  }
+}
+
+void XMLFileLoader::LoadPrototype(InfileTree* qe) {
+  std::string prototype = qe->GetString("name");
+  InfileTree* config = qe->SubTree("config");
+  std::string alias = config->GetElementName(0);
+
+  Sha1 hash;
+  HashTree(config, &hash);
+  qe->ReleaseSubTree(config);
+  Digest d = hash.digest();
+  std::map<Digest, Agent*>::iterator same = config_protos_.find(d);
+  if (same != config_protos_.end()) {
+    // the config was already parsed and read back for another prototype, so
+    // only the Agent level state differs. AddPrototype records the state of
+    // the clone.
+    Agent* agent = same->second->Clone();
+    agent->prototype(prototype);
+    agent->lifetime(OptionalQuery<int>(qe, "lifetime", -1));
+    ctx_->AddPrototype(prototype, agent);
+    return;
+  }
+
+  AgentSpec spec = specs_[alias];
+  Agent* agent = DynamicModule::Make(ctx_, spec);
+
+  // call manually without agent impl injected to keep all Agent state in a
+  // single, consolidated db table
+  agent->Agent::InfileToDb(qe, DbInit(agent, true));
+
+  agent->InfileToDb(qe, DbInit(agent));
+  rec_->Flush();
+
+  std::vector<Cond> conds;
+  conds.push_back(Cond("SimId", "==", rec_->sim_id()));
+  conds.push_back(Cond("SimTime", "==", static_cast<int>(0)));
+  conds.push_back(Cond("AgentId", "==", agent->id()));
+  CondInjector ci(b_, conds);
+  PrefixInjector pi(&ci, "AgentState");
+
+  // call manually without agent impl injected
+  agent->Agent::InitFrom(&pi);
+
+  pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
+  agent->InitFrom(&pi);
+  ctx_->AddPrototype(prototype, agent);
+  config_protos_[d] = agent;
+}
+
 Agent* XMLFileLoader::BuildAgent(std::string proto, Agent* parent) {
   Agent* m = ctx_->CreateAgent<Agent>(proto);
   m->Build(parent);
@@ -414,7 +634,7 @@ Agent* XMLFileLoader::BuildAgent(std::string proto, Agent* parent) {
 }
 
 void XMLFileLoader::LoadControlParams() {
-  InfileTree xqe(*parser_);
+  InfileTree& xqe = *tree_;
   std::string query = "/*/control";
   InfileTree* qe = xqe.SubTree(query);
 
@@ -436,9 +656,23 @@ void XMLFileLoader::LoadControlParams() {
   std::string d = OptionalQuery<std::string>(qe, "decay", "manual");
 
   SimInfo si(dur, y0, m0, handle, d);
+  si.decay_interval = OptionalQuery<int>(qe, "decay_interval", 1);
+  if (si.decay_interval < 1) {
+    throw ValueError("decay_interval must be at least 1");
+  }
 
   si.explicit_inventory = OptionalQuery<bool>(qe, "explicit_inventory", false);
   si.explicit_inventory_compact = OptionalQuery<bool>(qe, "explicit_inventory_compact", false);
+  si.compact_provenance = OptionalQuery<bool>(qe, "compact_provenance", false);
+  si.delta_snapshots = OptionalQuery<bool>(qe, "delta_snapshots", false);
+  si.checkpoint_interval = OptionalQuery<int>(qe, "checkpoint_interval", 0);
+  si.checkpoint_wall = OptionalQuery<double>(qe, "checkpoint_wall", 0);
+  si.checkpoint_backoff = OptionalQuery<double>(qe, "checkpoint_backoff", 0);
+  if (si.checkpoint_interval < 0 || si.checkpoint_wall < 0 ||
+      si.checkpoint_backoff < 0) {
+    throw ValueError("checkpoint_interval, checkpoint_wall and "
+                     "checkpoint_backoff must not be negative");
+  }
 
   // get time step duration
   si.dt = OptionalQuery<int>(qe, "dt", kDefaultTimeStepDur);
@@ -451,6 +685,22 @@ void XMLFileLoader::LoadControlParams() {
   double eps_rsrc_ = OptionalQuery<double>(qe, "tolerance_resource", 1e-6);
   cy_eps_rsrc = si.eps_rsrc = eps_rsrc_;
 
+  // get the recording policy, before anything is recorded
+  RecordPolicy policy;
+  int num_tables = qe->NMatches("record/table");
+  for (int i = 0; i < num_tables; i++) {
+    InfileTree* tqe = qe->SubTree("record/table", i);
+    TablePolicy& tp = policy[tqe->GetString("name")];
+    tp.drop = OptionalQuery<bool>(tqe, "drop", false);
+    tp.stride = OptionalQuery<int>(tqe, "stride", 1);
+    int num_backs = tqe->NMatches("backend");
+    for (int j = 0; j < num_backs; j++) {
+      tp.backends.insert(tqe->GetString("backend", j));
+    }
+  }
+  if (!policy.empty()) {
+    rec_->set_policy(policy);
+  }
 
   ctx_->InitSim(si);
 }
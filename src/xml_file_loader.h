@@ -25,6 +25,13 @@ void LoadRawStringstreamFromFile(std::stringstream& stream, std::string file);
 void LoadStringstreamFromFile(std::stringstream& stream, std::string file,
                               std::string format="none");
 
+/// Reads a JSON or Python input into json, converting Python to JSON. The
+/// given file path is the input itself if the format is not "none". Returns
+/// false without reading anything for XML inputs.
+/// The format may be "none", "xml", "json", or "py".
+bool LoadJsonFromFile(std::string& json, std::string file,
+                      std::string format="none");
+
 /// Reads the given file path and returns an XML string.
 /// The format may be "none", "xml", "json", or "py".
 std::string LoadStringFromFile(std::string file, std::string format="none");
@@ -33,12 +40,20 @@ std::string LoadStringFromFile(std::string file, std::string format="none");
 /// input file.
 std::vector<AgentSpec> ParseSpecs(std::string infile, std::string format="none");
 
+/// Returns a list of the full module+agent spec for all agents in the given
+/// input tree.
+std::vector<AgentSpec> ParseSpecs(InfileTree* tree);
+
 /// Builds and returns a master cyclus input xml schema that includes the
 /// sub-schemas defined by all installed cyclus modules (e.g. facility agents).
 /// This is used to validate simulation input files.
 std::string BuildMasterSchema(std::string schema_path, std::string infile,
                               std::string format="none");
 
+/// Builds the master cyclus input xml schema for the given agent specs.
+std::string BuildMasterSchema(std::string schema_path,
+                              std::vector<AgentSpec> specs);
+
 /// Creates a composition from the recipe in the query engine.
 Composition::Ptr ReadRecipe(InfileTree* qe);
 
@@ -53,7 +68,8 @@ class XMLFileLoader {
   /// to and initializing the backends in r. r must already have b registered.
   /// schema_file identifies the master xml rng schema used to validate the
   /// input file. The format specifies the input file format from one of:
-  /// "none", "xml", "json", or "py".
+  /// "none", "xml", "json", or "py". JSON inputs are queried directly (see
+  /// JsonInfileTree) and only converted to XML when they must be validated.
   XMLFileLoader(Recorder* r, QueryableBackend* b, std::string schema_file, 
                 const std::string input_file="", const std::string format="none", bool ms_print=false);
 
@@ -68,6 +84,19 @@ class XMLFileLoader {
   /// Load agent specs from the input file to a map by alias
   void LoadSpecs();
 
+  /// Validates the input file against the master schema. If input caching is
+  /// enabled (see Env::input_cache), inputs that were already validated are
+  /// not validated again, and the master schema is not built for them.
+  void ValidateInput();
+
+  /// Returns the input cache key of the input. It covers the input, the
+  /// cyclus version, the loader type, the schema template and the spec,
+  /// alias and schema of every archetype used. The digests of archetype
+  /// schemas are cached by library file and modification time (in the
+  /// "schemas" directory of the input cache), so unchanged archetypes do not
+  /// generate their schemas again.
+  std::string InputCacheKey();
+
   /// Method to load the simulation exchange solver.
   void LoadSolver();
 
@@ -84,6 +113,11 @@ class XMLFileLoader {
   /// Creates all initial agent instances from the input file.
   virtual void LoadInitialAgents();
 
+  /// Creates the prototype defined by qe and adds it to the context. A
+  /// prototype with the same config as an already loaded one is cloned from
+  /// it, skipping the InfileToDb parse and the database read back.
+  void LoadPrototype(InfileTree* qe);
+
   virtual std::string master_schema();
 
   /// Processes commodity priorities, such that any without a defined priority
@@ -109,9 +143,18 @@ class XMLFileLoader {
   // map<specalias, spec>
   std::map<std::string, AgentSpec> specs_;
 
-  /// the parser
+  /// the loaded prototypes by the hash of their config
+  std::map<Digest, Agent*> config_protos_;
+
+  /// the parser, NULL for a JSON input until it is validated
   boost::shared_ptr<XMLParser> parser_;
 
+  /// the tree all input queries are made on
+  boost::shared_ptr<InfileTree> tree_;
+
+  /// the raw text of a JSON input
+  std::string json_;
+
   /// the input file name
   std::string file_;
 
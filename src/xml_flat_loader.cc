@@ -12,6 +12,11 @@
 namespace cyclus {
 
 std::string BuildFlatMasterSchema(std::string schema_path, std::string infile) {
+  return BuildFlatMasterSchema(schema_path, ParseSpecs(infile));
+}
+
+std::string BuildFlatMasterSchema(std::string schema_path,
+                                  std::vector<AgentSpec> specs) {
   Timer ti;
   Recorder rec;
   Context ctx(&ti, &rec);
@@ -20,7 +25,6 @@ std::string BuildFlatMasterSchema(std::string schema_path, std::string infile) {
   LoadStringstreamFromFile(schema, schema_path);
   std::string master = schema.str();
 
-  std::vector<AgentSpec> specs = ParseSpecs(infile);
   std::string subschemas;
   for (int i = 0; i < specs.size(); ++i) {
     Agent* m = DynamicModule::Make(&ctx, specs[i]);
@@ -41,42 +45,17 @@ std::string BuildFlatMasterSchema(std::string schema_path, std::string infile) {
 }
 
 std::string XMLFlatLoader::master_schema() {
-  return BuildFlatMasterSchema(schema_path_, file_);
+  return BuildFlatMasterSchema(schema_path_, ParseSpecs(tree_.get()));
 }
 
 void XMLFlatLoader::LoadInitialAgents() {
-  InfileTree xqe(*parser_);
+  InfileTree& xqe = *tree_;
 
   // create prototypes
   int num_protos = xqe.NMatches("/*/prototype");
   for (int i = 0; i < num_protos; i++) {
     InfileTree* qe = xqe.SubTree("/*/prototype", i);
-    std::string prototype = qe->GetString("name");
-    std::string alias = qe->SubTree("config")->GetElementName(0);
-    AgentSpec spec = specs_[alias];
-
-    Agent* agent = DynamicModule::Make(ctx_, spec);
-
-    // call manually without agent impl injected to keep all Agent state in a
-    // single, consolidated db table
-    agent->Agent::InfileToDb(qe, DbInit(agent, true));
-
-    agent->InfileToDb(qe, DbInit(agent));
-    rec_->Flush();
-
-    std::vector<Cond> conds;
-    conds.push_back(Cond("SimId", "==", rec_->sim_id()));
-    conds.push_back(Cond("AgentId", "==", agent->id()));
-    conds.push_back(Cond("SimTime", "==", static_cast<int>(0)));
-    CondInjector ci(b_, conds);
-    PrefixInjector pi(&ci, "AgentState");
-
-    // call manually without agent impl injected
-    agent->Agent::InitFrom(&pi);
-
-    pi = PrefixInjector(&ci, "AgentState" + spec.Sanitize());
-    agent->InitFrom(&pi);
-    ctx_->AddPrototype(prototype, agent);
+    LoadPrototype(qe);
   }
 
   // retrieve agent hierarchy and initial inventories
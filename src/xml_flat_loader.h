@@ -11,6 +11,10 @@ namespace cyclus {
 /// validate simulation input files.
 std::string BuildFlatMasterSchema(std::string schema_path, std::string infile);
 
+/// Builds the flat master cyclus input xml schema for the given agent specs.
+std::string BuildFlatMasterSchema(std::string schema_path,
+                                  std::vector<AgentSpec> specs);
+
 /// a class that encapsulates the methods needed to load input to
 /// a cyclus simulation from xml
 class XMLFlatLoader : public XMLFileLoader {
@@ -0,0 +1,115 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "blob.h"
+#include "columnar_back.h"
+#include "error.h"
+#include "recorder.h"
+
+using cyclus::ColumnarBack;
+
+TEST(ColumnarBackTest, FixedWidthColumns) {
+  cyclus::Recorder r(false);
+  ColumnarBack back;
+  r.RegisterBackend(&back);
+  for (int i = 0; i < 5; ++i) {
+    r.NewDatum("Table")
+        ->AddVal("int", i)
+        ->AddVal("double", 1.5 * i)
+        ->AddVal("bool", i % 2 == 0)
+        ->Record();
+  }
+  r.Flush();
+
+  ColumnarBack::Table& t = back.GetTable("Table");
+  ASSERT_EQ(5, t.nrows);
+  ASSERT_EQ(3, t.cols.size());
+  EXPECT_EQ("int", t.cols[0].field);
+  EXPECT_EQ('i', t.cols[0].format);
+  EXPECT_EQ('d', t.cols[1].format);
+  EXPECT_EQ('?', t.cols[2].format);
+  ASSERT_EQ(5 * sizeof(double), t.cols[1].data.size());
+
+  const double* d = reinterpret_cast<const double*>(&t.cols[1].data[0]);
+  const bool* b = reinterpret_cast<const bool*>(&t.cols[2].data[0]);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_DOUBLE_EQ(1.5 * i, d[i]);
+    EXPECT_EQ(i % 2 == 0, b[i]);
+  }
+  r.Close();
+}
+
+TEST(ColumnarBackTest, EncodedAndObjectColumns) {
+  cyclus::Recorder r;
+  ColumnarBack back;
+  r.RegisterBackend(&back);
+  std::vector<int> v;
+  v.push_back(7);
+  for (int i = 0; i < 6; ++i) {
+    r.NewDatum("Table")
+        ->AddVal("commod", std::string(i < 4 ? "uox" : "mox"))
+        ->AddVal("blob", cyclus::Blob("x"))
+        ->AddVal("vec", v)
+        ->Record();
+  }
+  r.Flush();
+
+  ColumnarBack::Table& t = back.GetTable("Table");
+  ASSERT_EQ(6, t.nrows);
+  ASSERT_EQ(4, t.cols.size());
+
+  // the simulation id is the same in every row
+  EXPECT_EQ("SimId", t.cols[0].field);
+  EXPECT_TRUE(t.cols[0].encoded);
+  ASSERT_EQ(1, t.cols[0].values.size());
+  EXPECT_EQ(r.sim_id(), t.cols[0].values[0].cast<boost::uuids::uuid>());
+
+  const ColumnarBack::Column& commod = t.cols[1];
+  EXPECT_TRUE(commod.encoded);
+  ASSERT_EQ(2, commod.values.size());
+  EXPECT_EQ("uox", commod.values[0].cast<std::string>());
+  EXPECT_EQ("mox", commod.values[1].cast<std::string>());
+  const int* codes = reinterpret_cast<const int*>(&commod.data[0]);
+  EXPECT_EQ(0, codes[3]);
+  EXPECT_EQ(1, codes[4]);
+
+  EXPECT_TRUE(t.cols[2].encoded);
+  EXPECT_EQ(1, t.cols[2].values.size());
+
+  const ColumnarBack::Column& vec = t.cols[3];
+  EXPECT_EQ(0, vec.format);
+  EXPECT_TRUE(vec.data.empty());
+  ASSERT_EQ(6, vec.values.size());
+  EXPECT_EQ(v, vec.values[5].cast<std::vector<int> >());
+  r.Close();
+}
+
+TEST(ColumnarBackTest, Registry) {
+  cyclus::Recorder r(false);
+  ColumnarBack back;
+  r.RegisterBackend(&back);
+  std::set<std::string> reg;
+  reg.insert("Kept");
+  back.registry(reg);
+  back.store_all_tables(false);
+
+  r.NewDatum("Kept")->AddVal("x", 1)->Record();
+  r.NewDatum("Skipped")->AddVal("x", 1)->Record();
+  r.Flush();
+
+  std::set<std::string> tbls = back.Tables();
+  EXPECT_EQ(1, tbls.size());
+  EXPECT_EQ(1, tbls.count("Kept"));
+  EXPECT_THROW(back.GetTable("Skipped"), cyclus::KeyError);
+
+  // closing the recorder keeps the tables for later queries
+  r.Close();
+  EXPECT_EQ(1, back.GetTable("Kept").nrows);
+
+  EXPECT_TRUE(back.DropTable("Kept"));
+  EXPECT_FALSE(back.DropTable("Kept"));
+  EXPECT_TRUE(back.Tables().empty());
+}
@@ -4,6 +4,7 @@
 #include "composition.h"
 #include "cyc_limits.h"
 #include "error.h"
+#include "pyne.h"
 
 namespace cm = cyclus::compmath;
 using cyclus::Composition;
@@ -252,3 +253,74 @@ TEST(CompMathTests, Add) {
     EXPECT_DOUBLE_EQ(it->second, expect[it->first]);
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, NucTables) {
+  int nucs[] = {10010000, 922350000, 942390000, 551370000, 952421000};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_DOUBLE_EQ(pyne::atomic_mass(nucs[i]), cm::AtomicMass(nucs[i]));
+    EXPECT_DOUBLE_EQ(pyne::decay_const(nucs[i]), cm::DecayConst(nucs[i]));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, MassToAtom) {
+  CompMap mass;
+  mass[922350000] = 1.0;
+  mass[922380000] = 3.0;
+  mass[80160000] = 0.5;
+
+  CompMap atom;
+  cm::MassToAtom(mass, &atom);
+  ASSERT_EQ(mass.size(), atom.size());
+  for (CompMap::iterator it = mass.begin(); it != mass.end(); ++it) {
+    EXPECT_DOUBLE_EQ(it->second / pyne::atomic_mass(it->first),
+                     atom[it->first]);
+  }
+
+  CompMap back;
+  cm::AtomToMass(atom, &back);
+  EXPECT_TRUE(cm::AlmostEq(mass, back, 1e-14));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, MaxDecayConst) {
+  CompMap v;
+  v[922380000] = 1.0;
+  v[551370000] = 1.0;
+  v[10010000] = 1.0;
+  EXPECT_DOUBLE_EQ(pyne::decay_const(551370000), cm::MaxDecayConst(v));
+
+  CompMap stable;
+  stable[10010000] = 1.0;
+  EXPECT_EQ(0, cm::MaxDecayConst(stable));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CompMathTests, MassSum) {
+  CompMap v1;
+  v1[922350000] = 1;
+  v1[922380000] = 3;
+  CompMap v2;
+  v2[922380000] = 1;
+  v2[80160000] = 1;
+
+  cm::MassSum sum;
+  sum.Add(v1, 8);
+  sum.Add(v2, 2);
+  CompMap result;
+  sum.Take(&result);
+
+  CompMap expect;
+  expect[922350000] = 2;
+  expect[922380000] = 7;
+  expect[80160000] = 1;
+  EXPECT_TRUE(cm::AlmostEq(expect, result, 1e-15));
+
+  // the buffer is empty again after Take
+  sum.Add(v2, 4);
+  sum.Take(&result);
+  ASSERT_EQ(2, result.size());
+  EXPECT_DOUBLE_EQ(2, result[922380000]);
+  EXPECT_DOUBLE_EQ(2, result[80160000]);
+}
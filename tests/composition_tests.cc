@@ -1,3 +1,5 @@
+#include <climits>
+#include <cmath>
 #include <map>
 
 #include <gtest/gtest.h>
@@ -94,3 +96,53 @@ TEST(CompositionTests, decay) {
   EXPECT_NEAR(v[id("U238")], newv[id("U238")], 1e-4);
 }
 
+TEST(CompositionTests, DecayMass) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[id("Cs137")] = 1;
+  v[id("U238")] = 10;
+  Composition::Ptr c = Composition::CreateFromAtom(v);
+
+  int dt = 100;
+  uint64_t secs = kDefaultTimeStepDur;
+  EXPECT_EQ(Composition::Ptr(), c->FindDecay(dt));
+  int64_t misses = Composition::decay_stats().misses;
+  CompMap mass = c->DecayMass(dt, secs);
+
+  // nothing is added to the decay chain or counted
+  EXPECT_EQ(Composition::Ptr(), c->FindDecay(dt));
+  EXPECT_EQ(misses, Composition::decay_stats().misses);
+
+  Composition::Ptr decayed = c->Decay(dt, secs);
+  EXPECT_EQ(decayed, c->FindDecay(dt));
+  CompMap want = decayed->mass();
+  ASSERT_EQ(want.size(), mass.size());
+  CompMap::iterator it;
+  for (it = want.begin(); it != want.end(); ++it) {
+    EXPECT_DOUBLE_EQ(it->second, mass[it->first]);
+  }
+}
+
+TEST(CompositionTests, DecayThreshold) {
+  cyclus::Env::SetNucDataPath();
+
+  CompMap v;
+  v[id("U235")] = 1;
+  v[id("U238")] = 10;
+  Composition::Ptr c = Composition::CreateFromAtom(v);
+
+  double eps = 1e-3;
+  uint64_t secs = kDefaultTimeStepDur;
+  double lambda = pyne::decay_const(id("U235")) * static_cast<double>(secs);
+  int dt = c->DecayThreshold(secs, eps);
+  EXPECT_LT(1 - std::exp(-lambda * (dt - 1)), eps);
+  EXPECT_GE(1 - std::exp(-lambda * dt), eps);
+  EXPECT_EQ(dt, c->DecayThreshold(secs, eps));
+  EXPECT_GT(dt, c->DecayThreshold(12 * secs, eps));
+
+  CompMap stable;
+  stable[id("H1")] = 1;
+  c = Composition::CreateFromAtom(stable);
+  EXPECT_EQ(INT_MAX, c->DecayThreshold(secs, eps));
+}
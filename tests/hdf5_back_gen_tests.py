@@ -67,7 +67,7 @@ CONTAINER_TYPES = {'LIST': 'LIST', 'VL_LIST': 'LIST',
                    'PAIR': 'PAIR'}
 
 CREATE_FUNCTIONS = {'MAP': dict, 'LIST': list, 'SET': set, 'PAIR': list, 
-                    'VECTOR': list, 'INT': int, 'DOUBLE': float, 'FLOAT': float,
+                    'VECTOR': list, 'INT': int, 'LONG': int, 'DOUBLE': float, 'FLOAT': float,
                     'BOOL': bool, 'STRING': str, 'UUID': list, 'BLOB': str}
 
 UNIQUE_TYPES = ['MAP', 'SET']
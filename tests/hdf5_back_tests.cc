@@ -254,3 +254,79 @@ TEST(Hdf5BackTest, Tables) {
   EXPECT_LE(1, tabs.size());
   EXPECT_EQ(1, tabs.count("IntTable"));
 }
+
+TEST(Hdf5BackTest, VLGroupRepeatedKeys) {
+  using std::string;
+  using std::vector;
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  // many rows in a single group, with repeated variable length values, so
+  // that digests are computed in bulk and keys are deduplicated.
+  string names[] = {"apple", "banana", "cherry"};
+  vector<int> v = vector<int>(3, 42);
+  Recorder m;
+  Hdf5Back back(path);
+  m.RegisterBackend(&back);
+  for (int n = 0; n < 30; ++n) {
+    v[0] = n % 2;
+    m.NewDatum("VLTable")
+        ->AddVal("name", names[n % 3])
+        ->AddVal("n", n)
+        ->AddVal("vals", v)
+        ->Record();
+  }
+  m.Flush();
+
+  // query twice so the second pass is served by the read cache
+  for (int pass = 0; pass < 2; ++pass) {
+    cyclus::QueryResult qr = back.Query("VLTable", NULL);
+    ASSERT_EQ(30, qr.rows.size());
+    for (int n = 0; n < 30; ++n) {
+      EXPECT_EQ(n, qr.GetVal<int>("n", n));
+      EXPECT_EQ(names[n % 3], qr.GetVal<string>("name", n));
+      vector<int> obs = qr.GetVal<vector<int> >("vals", n);
+      ASSERT_EQ(3, obs.size());
+      EXPECT_EQ(n % 2, obs[0]);
+      EXPECT_EQ(42, obs[2]);
+    }
+  }
+  m.Close();
+}
+
+TEST(Hdf5BackTest, EncodeMixedRows) {
+  using std::string;
+  using std::vector;
+  using cyclus::Recorder;
+  using cyclus::Hdf5Back;
+  FileDeleter fd(path);
+
+  // a Resources-like table, mixing fixed and variable length columns, with
+  // many rows written as a single group through the compiled encoders.
+  vector<int> unit_shape = vector<int>(1, 8);
+  Recorder m;
+  Hdf5Back back(path);
+  m.RegisterBackend(&back);
+  for (int n = 0; n < 100; ++n) {
+    m.NewDatum("EncTable")
+        ->AddVal("ResourceId", n)
+        ->AddVal("Type", string(n % 2 == 0 ? "Material" : "Product"))
+        ->AddVal("Quantity", 0.5 * n)
+        ->AddVal("Units", string("kg"), &unit_shape)
+        ->AddVal("Parent1", n - 1)
+        ->Record();
+  }
+  m.Close();
+
+  cyclus::QueryResult qr = back.Query("EncTable", NULL);
+  ASSERT_EQ(100, qr.rows.size());
+  for (int n = 0; n < 100; ++n) {
+    EXPECT_EQ(n, qr.GetVal<int>("ResourceId", n));
+    EXPECT_EQ(n % 2 == 0 ? "Material" : "Product",
+              qr.GetVal<string>("Type", n));
+    EXPECT_DOUBLE_EQ(0.5 * n, qr.GetVal<double>("Quantity", n));
+    EXPECT_EQ("kg", qr.GetVal<string>("Units", n));
+    EXPECT_EQ(n - 1, qr.GetVal<int>("Parent1", n));
+  }
+}
@@ -152,3 +152,31 @@ TEST_F(InfileTreeTest, optional_queries) {
   EXPECT_EQ(str_val, OptionalQuery<string>(&qe, str_str, str_other));
   EXPECT_EQ(str_other, OptionalQuery<string>(&qe, other, str_other));
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(InfileTreeTest, indexed_matches_xpath) {
+  std::stringstream ss;
+  ss << "<root>"
+     << "<a><b><val>1</val><val>2</val></b><c>x</c></a>"
+     << "<a><b><val>3</val></b></a>"
+     << "<d>y</d>"
+     << "</root>";
+
+  cyclus::XMLParser parser;
+  parser.Init(ss);
+  cyclus::InfileTree qe(parser);
+
+  // simple paths are answered from the index, the ./ paths by XPath
+  EXPECT_EQ(qe.NMatches("./a/b/val"), qe.NMatches("a/b/val"));
+  EXPECT_EQ(3, qe.NMatches("a/b/val"));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(qe.GetString("./a/b/val", i), qe.GetString("a/b/val", i));
+  }
+  EXPECT_EQ(0, qe.NMatches("a/val"));
+  EXPECT_EQ(1, qe.NMatches("a/c"));
+  EXPECT_EQ(2, qe.NMatches("//b"));
+
+  cyclus::InfileTree* sub = qe.SubTree("a", 1);
+  EXPECT_EQ("3", sub->GetString("b/val"));
+  EXPECT_EQ(1, sub->NMatches("/root/d"));
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "error.h"
+#include "infile_tree.h"
+#include "json_infile_tree.h"
+#include "toolkit/infile_converters.h"
+#include "xml_parser.h"
+
+namespace {
+
+std::string Input() {
+  return "{\"root\": {"
+         "  \"a\": [{\"b\": {\"val\": [1, 2.5]}, \"c\": \"x\"},"
+         "         {\"b\": {\"val\": \"3\"}}],"
+         "  \"d\": true,"
+         "  \"e\": null,"
+         "  \"f\": [[\"p\", \"q\"], \"r\"]"
+         "}}";
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(JsonInfileTreeTest, matches_xml) {
+  std::stringstream ss(cyclus::toolkit::JsonToXml(Input()));
+  cyclus::XMLParser parser;
+  parser.Init(ss);
+  cyclus::InfileTree xml(parser);
+  cyclus::JsonInfileTree json(Input());
+
+  const char* queries[] = {"a", "a/b/val", "a/c", "d", "e", "f", "f/f", "*",
+                           "a/*", "/root/a", "/*/d", "g"};
+  for (int i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+    std::string q = queries[i];
+    ASSERT_EQ(xml.NMatches(q), json.NMatches(q)) << q;
+  }
+
+  EXPECT_EQ(xml.NElements(), json.NElements());
+  for (int i = 0; i < json.NElements(); ++i) {
+    EXPECT_EQ(xml.GetElementName(i), json.GetElementName(i));
+  }
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(xml.GetString("a/b/val", i), json.GetString("a/b/val", i));
+  }
+  EXPECT_EQ(xml.GetString("d"), json.GetString("d"));
+  EXPECT_EQ(3, json.NMatches("f"));
+  EXPECT_EQ(xml.GetString("f", 1), json.GetString("f", 1));
+  EXPECT_THROW(json.GetString("e"), cyclus::ValueError);
+  EXPECT_THROW(json.GetString("g"), cyclus::KeyError);
+
+  cyclus::InfileTree* sub = json.SubTree("a", 1);
+  EXPECT_EQ("3", sub->GetString("b/val"));
+  EXPECT_EQ("3", sub->SubTree("b/val")->GetString("."));
+  EXPECT_EQ(1, sub->NMatches("/root/d"));
+  EXPECT_EQ("b", sub->GetElementName(0));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(JsonInfileTreeTest, throws) {
+  EXPECT_THROW(cyclus::JsonInfileTree("{\"root\": "), cyclus::ValidationError);
+  EXPECT_THROW(cyclus::JsonInfileTree("{\"a\": 1, \"b\": 2}"),
+               cyclus::ValidationError);
+
+  cyclus::JsonInfileTree json(Input());
+  EXPECT_THROW(json.NMatches("//b"), cyclus::ValueError);
+  EXPECT_THROW(json.NMatches("a[1]"), cyclus::ValueError);
+}
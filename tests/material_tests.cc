@@ -4,9 +4,11 @@
 
 #include <gtest/gtest.h>
 
+#include "comp_math.h"
 #include "cyc_limits.h"
 #include "toolkit/mat_query.h"
 #include "error.h"
+#include "pool_alloc.h"
 
 using pyne::nucname::id;
 
@@ -27,6 +29,18 @@ TEST_F(MaterialTest, Clone) {
   EXPECT_DOUBLE_EQ(test_mat_->quantity(), clone_mat->quantity());
 }
 
+TEST_F(MaterialTest, PooledAllocation) {
+  PoolStats before = pool_stats<Material>();
+  {
+    Resource::Ptr clone_mat = test_mat_->Clone();
+    Material::Ptr other = test_mat_->ExtractQty(test_size_ / 2);
+    EXPECT_EQ(before.allocs + 2, pool_stats<Material>().allocs);
+    EXPECT_EQ(before.live() + 2, pool_stats<Material>().live());
+    EXPECT_LE(pool_stats<Material>().live(), pool_stats<Material>().peak);
+  }
+  EXPECT_EQ(before.live(), pool_stats<Material>().live());
+}
+
 TEST_F(MaterialTest, ExtractRes) {
   EXPECT_DOUBLE_EQ(test_size_, test_mat_->quantity());
   double other_size = test_size_ / 3;
@@ -121,6 +135,45 @@ TEST_F(MaterialTest, AbsorbUnlikeMaterial) {
   EXPECT_DOUBLE_EQ(orig + origdiff, default_mat_->quantity());
 }
 
+TEST_F(MaterialTest, AbsorbMany) {
+  CompMap v;
+  v[pb208_] = 1.0 * units::g;
+  v[am241_] = 1.0 * units::g;
+  Composition::Ptr diff_comp = Composition::CreateFromMass(v);
+
+  std::vector<Material::Ptr> mats;
+  mats.push_back(Material::CreateUntracked(test_size_, diff_comp));
+  mats.push_back(Material::CreateUntracked(2 * test_size_, test_comp_));
+  mats.push_back(Material::CreateUntracked(3 * test_size_, diff_comp));
+  Material::Ptr seq = Material::CreateUntracked(test_mat_->quantity(),
+                                                test_mat_->comp());
+  for (int i = 0; i < mats.size(); ++i) {
+    seq->Absorb(Material::CreateUntracked(mats[i]->quantity(),
+                                          mats[i]->comp()));
+  }
+
+  ASSERT_NO_THROW(test_mat_->Absorb(mats));
+  EXPECT_DOUBLE_EQ(7 * test_size_, test_mat_->quantity());
+  for (int i = 0; i < mats.size(); ++i) {
+    EXPECT_DOUBLE_EQ(0, mats[i]->quantity());
+  }
+
+  cyclus::toolkit::MatQuery mq(test_mat_);
+  cyclus::toolkit::MatQuery mqseq(seq);
+  EXPECT_DOUBLE_EQ(mqseq.mass(u235_), mq.mass(u235_));
+  EXPECT_DOUBLE_EQ(mqseq.mass(pb208_), mq.mass(pb208_));
+  EXPECT_DOUBLE_EQ(mqseq.mass(am241_), mq.mass(am241_));
+
+  // absorbing materials of the same composition does not create a new one
+  Composition::Ptr c = test_mat_->comp();
+  std::vector<Material::Ptr> same;
+  same.push_back(Material::CreateUntracked(test_size_, c));
+  same.push_back(Material::CreateUntracked(test_size_, c));
+  ASSERT_NO_THROW(test_mat_->Absorb(same));
+  EXPECT_EQ(c, test_mat_->comp());
+  EXPECT_DOUBLE_EQ(9 * test_size_, test_mat_->quantity());
+}
+
 TEST_F(MaterialTest, AbsorbZeroMaterial) {
   Material::Ptr same_as_test_mat = Material::CreateUntracked(0, test_comp_);
   EXPECT_NO_THROW(test_mat_->Absorb(same_as_test_mat));
@@ -227,6 +280,38 @@ TEST_F(MaterialTest, DecayManual) {
   EXPECT_NE(am241_qty, mq.mass(am241_));
 }
 
+TEST_F(MaterialTest, DecayBulk) {
+  // reference results, decayed one by one in separate decay chains
+  Material::Ptr ref_test = Material::CreateUntracked(
+      test_size_, Composition::CreateFromMass(test_comp_->mass()));
+  Material::Ptr ref_diff = Material::CreateUntracked(
+      test_size_, Composition::CreateFromMass(diff_comp_->mass()));
+  ref_test->Decay(100);
+  ref_diff->Decay(100);
+
+  std::vector<Material::Ptr> mats;
+  mats.push_back(test_mat_);
+  mats.push_back(diff_mat_);
+  mats.push_back(two_test_mat_);
+  Material::Decay(mats, 100);
+
+  // materials sharing a composition share the decayed one too
+  EXPECT_EQ(test_mat_->comp(), two_test_mat_->comp());
+  for (int i = 0; i < mats.size(); ++i) {
+    EXPECT_EQ(100, mats[i]->prev_decay_time());
+  }
+
+  cyclus::CompMap want = ref_diff->comp()->mass();
+  cyclus::CompMap got = diff_mat_->comp()->mass();
+  ASSERT_EQ(want.size(), got.size());
+  cyclus::CompMap::iterator it;
+  for (it = want.begin(); it != want.end(); ++it) {
+    EXPECT_DOUBLE_EQ(it->second, got[it->first]);
+  }
+  EXPECT_TRUE(cyclus::compmath::AlmostEq(ref_test->comp()->mass(),
+                                         test_mat_->comp()->mass(), 1e-15));
+}
+
 TEST_F(MaterialTest, DecayLazy) {
   SimInfo si(100, 2015, 1, "", "lazy");
   cyclus::Context ctx(&ti, &rec);
@@ -258,6 +343,29 @@ TEST_F(MaterialTest, DecayLazy) {
   EXPECT_NE(am241_qty, mq.mass(am241_));
 }
 
+TEST_F(MaterialTest, DecayInterval) {
+  SimInfo si(100, 2015, 1, "", "lazy");
+  si.decay_interval = 12;
+  cyclus::Context ctx(&ti, &rec);
+  ctx.InitSim(si);
+  Agent* a = new TestFacility(&ctx);
+  Material::Ptr m1 = Material::Create(a, 1000, diff_comp_);
+  Material::Ptr m2 = Material::Create(a, 10, diff_comp_);
+
+  ti.RunSim();
+  ASSERT_EQ(si.duration, ctx.time());
+
+  // decays are rounded down to whole intervals
+  Composition::Ptr c = m1->comp();
+  EXPECT_EQ(96, m1->prev_decay_time());
+  EXPECT_NE(diff_comp_, c);
+
+  // the second material finds the decayed composition in the decay chain
+  Composition::DecayStats before = Composition::decay_stats();
+  EXPECT_EQ(c, m2->comp());
+  EXPECT_EQ(before.hits + 1, Composition::decay_stats().hits);
+}
+
 TEST_F(MaterialTest, DecayDefault) {
   cyclus::toolkit::MatQuery orig(tracked_mat_);
   double u235_qty = orig.mass(u235_);
@@ -97,7 +97,7 @@ TEST(MockTests, ReconstructMaterial) {
   sim.Run();
 
   QueryResult qr = sim.db().Query("Transactions", NULL);
-  Material::Ptr mat = sim.GetMaterial(qr.GetVal<int>("ResourceId"));
+  Material::Ptr mat = sim.GetMaterial(qr.GetVal<int64_t>("ResourceId"));
   toolkit::MatQuery mq(mat);
 
   double cap = 10;
@@ -0,0 +1,112 @@
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <gtest/gtest.h>
+
+#include "partition_back.h"
+#include "recorder.h"
+
+namespace fs = boost::filesystem;
+
+static std::string const storepath = "partition_store_test";
+
+class PartitionBackTests : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    fs::remove_all(storepath);
+    sim1 = boost::uuids::random_generator()();
+    sim2 = boost::uuids::random_generator()();
+  }
+
+  virtual void TearDown() {
+    fs::remove_all(storepath);
+  }
+
+  // records n rows to the store as a separate writer (i.e. process) would.
+  void Record(boost::uuids::uuid simid, int n) {
+    cyclus::PartitionBack b(storepath);
+    cyclus::Recorder r(simid);
+    r.RegisterBackend(&b);
+    for (int i = 0; i < n; ++i) {
+      r.NewDatum("Sweep")
+          ->AddVal("Step", i)
+          ->Record();
+    }
+    r.Close();
+  }
+
+  boost::uuids::uuid sim1;
+  boost::uuids::uuid sim2;
+};
+
+TEST_F(PartitionBackTests, OnePartitionPerSim) {
+  Record(sim1, 3);
+  Record(sim2, 5);
+
+  cyclus::PartitionBack b(storepath);
+  std::vector<boost::uuids::uuid> simids = b.SimIds();
+  EXPECT_EQ(2, simids.size());
+  EXPECT_TRUE(fs::exists(fs::path(storepath) / cyclus::PartitionBack::kCatalogName));
+  EXPECT_EQ(1, b.Tables().count("Sweep"));
+}
+
+TEST_F(PartitionBackTests, QueryAllPartitions) {
+  Record(sim1, 3);
+  Record(sim2, 5);
+
+  cyclus::PartitionBack b(storepath);
+  cyclus::QueryResult qr = b.Query("Sweep", NULL);
+  EXPECT_EQ(8, qr.rows.size());
+  EXPECT_EQ(cyclus::INT, b.ColumnTypes("Sweep")["Step"]);
+}
+
+TEST_F(PartitionBackTests, SimIdPushdown) {
+  Record(sim1, 3);
+  Record(sim2, 5);
+
+  cyclus::PartitionBack b(storepath);
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("SimId", "==", sim2));
+  cyclus::QueryResult qr = b.Query("Sweep", &conds);
+  ASSERT_EQ(5, qr.rows.size());
+  EXPECT_EQ(sim2, qr.GetVal<boost::uuids::uuid>("SimId", 4));
+
+  conds.push_back(cyclus::Cond("Step", ">=", 3));
+  qr = b.Query("Sweep", &conds);
+  EXPECT_EQ(2, qr.rows.size());
+
+  conds[0] = cyclus::Cond("SimId", "==", boost::uuids::random_generator()());
+  qr = b.Query("Sweep", &conds);
+  EXPECT_EQ(0, qr.rows.size());
+  EXPECT_EQ(2, qr.fields.size());
+}
+
+TEST_F(PartitionBackTests, MissingTable) {
+  Record(sim1, 1);
+  cyclus::PartitionBack b(storepath);
+  EXPECT_THROW(b.Query("NotATable", NULL), cyclus::ValueError);
+}
+
+TEST_F(PartitionBackTests, LivePartitionsNotQueried) {
+  Record(sim1, 3);
+
+  // a writer that has not closed yet
+  cyclus::PartitionBack live(storepath);
+  cyclus::Recorder r(sim2);
+  r.RegisterBackend(&live);
+  r.NewDatum("Sweep")
+      ->AddVal("Step", 0)
+      ->Record();
+  r.Flush();
+
+  cyclus::PartitionBack b(storepath);
+  EXPECT_EQ(2, b.SimIds().size());
+  EXPECT_EQ(3, b.Query("Sweep", NULL).rows.size());
+  EXPECT_EQ(4, live.Query("Sweep", NULL).rows.size());
+
+  r.Close();
+  live.Close();
+  EXPECT_EQ(4, b.Query("Sweep", NULL).rows.size());
+}
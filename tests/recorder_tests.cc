@@ -216,6 +216,79 @@ TEST(RecorderTest, Datum_addVal) {
   EXPECT_EQ(d, back.data.back());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(RecorderTest, Policy_DropAndStride) {
+  using cyclus::Recorder;
+  TestBack back;
+  Recorder m;
+  m.RegisterBackend(&back);
+
+  cyclus::RecordPolicy p;
+  p["Dropped"].drop = true;
+  p["Sampled"].stride = 3;
+  m.set_policy(p);
+
+  for (int t = 0; t < 7; ++t) {
+    m.NewDatum("Dropped", t)->AddVal("t", t)->Record();
+    m.NewDatum("Sampled", t)->AddVal("t", t)->Record();
+    m.NewDatum("Full", t)->AddVal("t", t)->Record();
+  }
+  EXPECT_TRUE(m.Filtered("Dropped", 3));
+  EXPECT_FALSE(m.Filtered("Sampled", 3));
+  EXPECT_TRUE(m.Filtered("Sampled", 4));
+  EXPECT_FALSE(m.Filtered("Full", 4));
+  m.Close();
+
+  std::map<std::string, std::vector<int> > times;
+  for (int i = 0; i < back.data.size(); ++i) {
+    times[back.data[i]->title()].push_back(
+        back.data[i]->vals()[1].second.cast<int>());
+  }
+  EXPECT_EQ(times.count("Dropped"), 0);
+  EXPECT_EQ(times["Full"].size(), 7);
+  ASSERT_EQ(times["Sampled"].size(), 3);
+  EXPECT_EQ(times["Sampled"][0], 0);
+  EXPECT_EQ(times["Sampled"][1], 3);
+  EXPECT_EQ(times["Sampled"][2], 6);
+
+  // the discarding datum stores nothing
+  cyclus::Datum* d = m.NewDatum("Dropped", 0)->AddVal("t", 0);
+  EXPECT_EQ(d->vals().size(), 0);
+
+  p["Sampled"].stride = 0;
+  EXPECT_THROW(m.set_policy(p), cyclus::ValueError);
+}
+
+class NamedBack : public TestBack {
+ public:
+  NamedBack(std::string name) : name_(name) {}
+  virtual std::string Name() { return name_; }
+ private:
+  std::string name_;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(RecorderTest, Policy_Routing) {
+  using cyclus::Recorder;
+  NamedBack full("full.h5");
+  NamedBack small("small.sqlite");
+  Recorder m;
+  m.RegisterBackend(&full);
+  m.RegisterBackend(&small);
+
+  cyclus::RecordPolicy p;
+  p["Compositions"].backends.insert("full.h5");
+  m.set_policy(p);
+
+  m.NewDatum("Compositions")->AddVal("x", 1)->Record();
+  m.NewDatum("Transactions")->AddVal("x", 2)->Record();
+  m.Close();
+
+  ASSERT_EQ(full.data.size(), 2);
+  ASSERT_EQ(small.data.size(), 1);
+  EXPECT_EQ(small.data[0]->title(), "Transactions");
+}
+
 
 //
 // Raw Recorder Test
@@ -0,0 +1,179 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "context.h"
+#include "material.h"
+#include "rec_backend.h"
+#include "recorder.h"
+#include "region.h"
+#include "res_lineage.h"
+#include "timer.h"
+
+using cyclus::Material;
+
+namespace {
+
+class Dummy : public cyclus::Region {
+ public:
+  Dummy(cyclus::Context* ctx) : cyclus::Region(ctx) {}
+  Dummy* Clone() { return NULL; }
+};
+
+/// Keeps the Resources rows as ResourceId -> (Parent1, Parent2) and counts
+/// the rows of every table.
+class LineageBack : public cyclus::RecBackend {
+ public:
+  virtual void Notify(cyclus::DatumList data) {
+    for (int i = 0; i < data.size(); ++i) {
+      std::string title = data[i]->title();
+      counts[title]++;
+      if (title != "Resources") {
+        continue;
+      }
+
+      std::map<std::string, int64_t> row;
+      const cyclus::Datum::Vals& vals = data[i]->vals();
+      for (int j = 0; j < vals.size(); ++j) {
+        std::string f = vals[j].first;
+        if (f == "ResourceId" || f == "Parent1" || f == "Parent2") {
+          row[f] = vals[j].second.cast<int64_t>();
+        }
+      }
+      resources[row["ResourceId"]] =
+          std::make_pair(row["Parent1"], row["Parent2"]);
+    }
+  }
+
+  virtual std::string Name() { return "LineageBack"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  std::map<std::string, int> counts;
+  std::map<int64_t, std::pair<int64_t, int64_t> > resources;
+};
+
+}  // namespace
+
+class ResLineageTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    rec.RegisterBackend(&back);
+    ctx = new cyclus::Context(&ti, &rec);
+    cyclus::SimInfo si(10);
+    si.compact_provenance = true;
+    ctx->InitSim(si);
+
+    cyclus::CompMap v;
+    v[922350000] = 1;
+    c = cyclus::Composition::CreateFromMass(v);
+    dummy = new Dummy(ctx);
+  }
+
+  virtual void TearDown() {
+    delete ctx;
+    rec.Close();
+  }
+
+  LineageBack back;
+  cyclus::Timer ti;
+  cyclus::Recorder rec;
+  cyclus::Context* ctx;
+  cyclus::Composition::Ptr c;
+  cyclus::Agent* dummy;
+};
+
+TEST_F(ResLineageTest, SplitThenAbsorb) {
+  Material::Ptr m1 = Material::Create(dummy, 3, c);
+  Material::Ptr m2 = Material::Create(dummy, 7, c);
+  int64_t m1_created = m1->state_id();
+  int64_t m2_created = m2->state_id();
+
+  Material::Ptr e = m1->ExtractQty(1);
+  int64_t extracted = e->state_id();
+  m2->Absorb(e);
+
+  ctx->lineage()->Flush();
+  rec.Flush();
+
+  // the extracted state never left the time step
+  EXPECT_EQ(4, back.counts["Resources"]);
+  EXPECT_EQ(2, back.counts["ResCreators"]);
+  EXPECT_EQ(0, back.resources.count(extracted));
+  ASSERT_EQ(1, back.resources.count(m2->state_id()));
+  EXPECT_EQ(m2_created, back.resources[m2->state_id()].first);
+  EXPECT_EQ(m1_created, back.resources[m2->state_id()].second);
+  ASSERT_EQ(1, back.resources.count(m1->state_id()));
+  EXPECT_EQ(m1_created, back.resources[m1->state_id()].first);
+}
+
+TEST_F(ResLineageTest, PinnedStateKept) {
+  Material::Ptr m1 = Material::Create(dummy, 3, c);
+  Material::Ptr m2 = Material::Create(dummy, 7, c);
+
+  Material::Ptr e = m1->ExtractQty(1);
+  int64_t extracted = e->state_id();
+  ctx->lineage()->Pin(extracted);
+  m2->Absorb(e);
+
+  ctx->lineage()->Flush();
+  rec.Flush();
+
+  EXPECT_EQ(5, back.counts["Resources"]);
+  ASSERT_EQ(1, back.resources.count(extracted));
+  EXPECT_EQ(extracted, back.resources[m2->state_id()].second);
+}
+
+TEST_F(ResLineageTest, ManyParents) {
+  Material::Ptr m1 = Material::Create(dummy, 3, c);
+  std::vector<Material::Ptr> mats;
+  for (int i = 0; i < 3; ++i) {
+    Material::Ptr m = Material::Create(dummy, 1, c);
+    mats.push_back(m->ExtractQty(0.5));
+  }
+  m1->Absorb(mats);
+
+  ctx->lineage()->Flush();
+  rec.Flush();
+
+  // 4 created and 3 remaining split states plus the combined state
+  EXPECT_EQ(8, back.counts["Resources"]);
+  EXPECT_EQ(4, back.counts["ResourceParents"]);
+}
+
+TEST(ResTrackerTest, AbsorbManyUncompacted) {
+  LineageBack back;
+  cyclus::Timer ti;
+  cyclus::Recorder rec;
+  rec.RegisterBackend(&back);
+  cyclus::Context* ctx = new cyclus::Context(&ti, &rec);
+  ctx->InitSim(cyclus::SimInfo(10));
+  cyclus::CompMap v;
+  v[922350000] = 1;
+  cyclus::Composition::Ptr c = cyclus::Composition::CreateFromMass(v);
+  Dummy* dummy = new Dummy(ctx);
+
+  Material::Ptr m1 = Material::Create(dummy, 3, c);
+  int64_t m1_created = m1->state_id();
+  std::vector<Material::Ptr> mats;
+  for (int i = 0; i < 3; ++i) {
+    mats.push_back(Material::Create(dummy, 1, c));
+  }
+  int64_t first = mats[0]->state_id();
+  m1->Absorb(mats);
+  rec.Flush();
+
+  // the 4 created states plus a single combined state that lists all of its
+  // parents
+  EXPECT_EQ(5, back.counts["Resources"]);
+  EXPECT_EQ(5, back.counts["MaterialInfo"]);
+  EXPECT_EQ(4, back.counts["ResourceParents"]);
+  ASSERT_EQ(1, back.resources.count(m1->state_id()));
+  EXPECT_EQ(m1_created, back.resources[m1->state_id()].first);
+  EXPECT_EQ(first, back.resources[m1->state_id()].second);
+
+  delete ctx;
+  rec.Close();
+}
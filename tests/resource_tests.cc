@@ -46,26 +46,42 @@ class ResourceTest : public ::testing::Test {
 };
 
 TEST_F(ResourceTest, MaterialAbsorbTrackid) {
-  int obj_id = m1->obj_id();
+  int64_t obj_id = m1->obj_id();
   m1->Absorb(m2);
   EXPECT_EQ(obj_id, m1->obj_id());
 }
 
 TEST_F(ResourceTest, MaterialAbsorbGraphid) {
-  int state_id = m1->state_id();
+  int64_t state_id = m1->state_id();
   m1->Absorb(m2);
   EXPECT_LT(state_id, m1->state_id());
 }
 
+TEST_F(ResourceTest, MaterialAbsorbManyGraphid) {
+  cyclus::CompMap v; v[922380000] = 1;
+  cyclus::Composition::Ptr c = cyclus::Composition::CreateFromMass(v);
+  Material::Ptr m3 = Material::CreateUntracked(5, c);
+  std::vector<Material::Ptr> mats;
+  mats.push_back(m2);
+  mats.push_back(m3);
+
+  int64_t obj_id = m1->obj_id();
+  int64_t state_id = m1->state_id();
+  m1->Absorb(mats);
+  EXPECT_EQ(obj_id, m1->obj_id());
+  EXPECT_LT(state_id, m1->state_id());
+  EXPECT_DOUBLE_EQ(15, m1->quantity());
+}
+
 TEST_F(ResourceTest, MaterialExtractTrackid) {
-  int obj_id = m1->obj_id();
+  int64_t obj_id = m1->obj_id();
   Material::Ptr m3 = m1->ExtractQty(2);
   EXPECT_EQ(obj_id, m1->obj_id());
   EXPECT_LT(obj_id, m3->obj_id());
 }
 
 TEST_F(ResourceTest, MaterialExtractGraphid) {
-  int state_id = m1->state_id();
+  int64_t state_id = m1->state_id();
   Material::Ptr m3 = m1->ExtractQty(2);
   EXPECT_LT(state_id, m1->state_id());
   EXPECT_LT(state_id, m3->state_id());
@@ -73,26 +89,26 @@ TEST_F(ResourceTest, MaterialExtractGraphid) {
 }
 
 TEST_F(ResourceTest, ProductAbsorbTrackid) {
-  int obj_id = p1->obj_id();
+  int64_t obj_id = p1->obj_id();
   p1->Absorb(p2);
   EXPECT_EQ(obj_id, p1->obj_id());
 }
 
 TEST_F(ResourceTest, ProductAbsorbGraphid) {
-  int state_id = p1->state_id();
+  int64_t state_id = p1->state_id();
   p1->Absorb(p2);
   EXPECT_LT(state_id, p1->state_id());
 }
 
 TEST_F(ResourceTest, ProductExtractTrackid) {
-  int obj_id = p1->obj_id();
+  int64_t obj_id = p1->obj_id();
   Product::Ptr p3 = p1->Extract(2);
   EXPECT_EQ(obj_id, p1->obj_id());
   EXPECT_LT(obj_id, p3->obj_id());
 }
 
 TEST_F(ResourceTest, ProductExtractGraphid) {
-  int state_id = p1->state_id();
+  int64_t state_id = p1->state_id();
   Product::Ptr p3 = p1->Extract(2);
   EXPECT_LT(state_id, p1->state_id());
   EXPECT_LT(state_id, p3->state_id());
@@ -1,3 +1,8 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "comp_math.h"
@@ -158,6 +163,7 @@ class SimInitTest : public ::testing::Test {
   int compid() { return cy::Composition::next_id_; }
   int prodid() { return cy::Product::next_qualid_; }
   int transid(cy::Context* ctx) { return ctx->trans_id_; }
+  void settime(cy::Timer* ti, int t) { ti->time_ = t; }
 
   cy::SimInfo siminfo(cy::Context* ctx) { return ctx->si_; }
   std::set<Agent*> agent_list(cy::Context* ctx) { return ctx->agent_list_; }
@@ -421,6 +427,254 @@ TEST_F(SimInitTest, InitAgentInventories) {
   }
 }
 
+TEST_F(SimInitTest, InitInventoriesShareComps) {
+  cy::SimInit si;
+  si.Init(&rec, b);
+  std::set<Agent*> init_agents = agent_list(si.context());
+
+  int nagents = 0;
+  std::set<Agent*>::iterator it;
+  for (it = init_agents.begin(); it != init_agents.end(); ++it) {
+    Inver* a = dynamic_cast<Inver*>(*it);
+    if (a->enter_time() == -1) {
+      continue;
+    }
+    nagents++;
+
+    // buf1 and the first material of buf2 were both made from recipe1
+    ASSERT_EQ(1, a->buf1.count());
+    ASSERT_EQ(2, a->buf2.count());
+    cy::Material::Ptr m1 = a->buf1.Pop<cy::Material>();
+    cy::Material::Ptr m2 = a->buf2.Pop<cy::Material>();
+    cy::Material::Ptr m3 = a->buf2.Pop<cy::Material>();
+    EXPECT_EQ(m1->comp(), m2->comp());
+    EXPECT_NE(m1->comp(), m3->comp());
+    EXPECT_EQ(m3->qual_id(), m3->comp()->id());
+  }
+  EXPECT_EQ(2, nagents);
+}
+
+TEST_F(SimInitTest, DeltaSnapshots) {
+  cy::SqliteBack back(dbpath);
+  cy::Recorder r;
+  r.RegisterBackend(&back);
+  cy::Timer t;
+  cy::Context* c = new cy::Context(&t, &r);
+  cy::SimInfo info(5);
+  info.delta_snapshots = true;
+  c->InitSim(info);
+  c->AddRecipe("recipe1", ctx->GetRecipe("recipe1"));
+  c->AddRecipe("recipe2", ctx->GetRecipe("recipe2"));
+
+  Inver* a1 = new Inver(c);
+  a1->spec(":Inver:Inver");
+  a1->Build(NULL);
+  Inver* a2 = new Inver(c);
+  a2->spec(":Inver:Inver");
+  a2->Build(NULL);
+
+  cy::SimInit::Snapshot(c);  // records both agents
+  cy::SimInit::Snapshot(c);  // nothing changed
+  a1->val1 = 7;
+  cy::SimInit::Snapshot(c);  // a1 state changed
+  a2->buf1.Push(cy::Material::Create(a2, 1, c->GetRecipe("recipe1")));
+  cy::SimInit::Snapshot(c);  // a2 inventory changed
+  r.Flush();
+
+  std::vector<cy::Cond> conds;
+  conds.push_back(cy::Cond("AgentId", "==", a1->id()));
+  EXPECT_EQ(2, back.Query("AgentStateAgent", &conds).rows.size());
+  conds[0] = cy::Cond("AgentId", "==", a2->id());
+  EXPECT_EQ(2, back.Query("AgentStateAgent", &conds).rows.size());
+  EXPECT_EQ(4, back.Query("Snapshots", NULL).rows.size());
+
+  r.Close();
+  delete c;
+}
+
+TEST_F(SimInitTest, RestartDeltaSnapshots) {
+  cy::SqliteBack back(dbpath);
+  cy::Recorder r;
+  r.RegisterBackend(&back);
+  cy::Timer t;
+  cy::Context* c = new cy::Context(&t, &r);
+  c->NewDatum("SolverInfo")
+      ->AddVal("Solver", std::string("greedy"))
+      ->AddVal("ExclusiveOrders", true)
+      ->Record();
+  cy::SimInfo info(5);
+  info.delta_snapshots = true;
+  c->InitSim(info);
+  // fresh compositions, so that they are recorded in this simulation's db
+  cy::CompMap v;
+  v[922350000] = 1;
+  c->AddRecipe("recipe1", cy::Composition::CreateFromMass(v));
+  v[922380000] = 1;
+  c->AddRecipe("recipe2", cy::Composition::CreateFromMass(v));
+  Inver* p = new Inver(c);
+  p->spec(":Inver:Inver");
+  c->AddPrototype("proto1", p);
+
+  Inver* a1 = new Inver(c);
+  a1->spec(":Inver:Inver");
+  a1->Build(NULL);
+  Inver* a2 = new Inver(c);
+  a2->spec(":Inver:Inver");
+  a2->val1 = 5;
+  a2->Build(NULL);
+  cy::SimInit::Snapshot(c);  // records both agents
+
+  settime(&t, 1);
+  a1->val1 = 7;
+  cy::SimInit::Snapshot(c);  // only a1 changed
+
+  settime(&t, 2);
+  a1->val1 = 9;
+  a1->buf1.Push(cy::Material::Create(a1, 4, c->GetRecipe("recipe2")));
+  cy::SimInit::Snapshot(c);  // only a1 changed
+  r.Flush();
+
+  // a2 is only in the first snapshot, so both of its state and inventories
+  // must be found at an earlier time than the restart time.
+  std::vector<cy::Cond> conds;
+  conds.push_back(cy::Cond("AgentId", "==", a2->id()));
+  ASSERT_EQ(1, back.Query("AgentStateAgent", &conds).rows.size());
+
+  cy::SimInit si;
+  si.Restart(&back, r.sim_id(), 2);
+  std::set<Agent*> agents = agent_list(si.context());
+  std::map<int, Inver*> byid;
+  std::set<Agent*>::iterator it;
+  for (it = agents.begin(); it != agents.end(); ++it) {
+    if ((*it)->enter_time() != -1) {
+      byid[(*it)->id()] = dynamic_cast<Inver*>(*it);
+    }
+  }
+  ASSERT_EQ(2, byid.size());
+  Inver* init1 = byid[a1->id()];
+  Inver* init2 = byid[a2->id()];
+  ASSERT_TRUE(init1 != NULL);
+  ASSERT_TRUE(init2 != NULL);
+
+  EXPECT_EQ(9, init1->val1);
+  ASSERT_EQ(2, init1->buf1.count());
+  EXPECT_DOUBLE_EQ(5, init1->buf1.quantity());
+  ASSERT_EQ(2, init1->buf2.count());
+  EXPECT_DOUBLE_EQ(5, init1->buf2.quantity());
+
+  EXPECT_EQ(5, init2->val1);
+  ASSERT_EQ(1, init2->buf1.count());
+  EXPECT_DOUBLE_EQ(1, init2->buf1.quantity());
+  ASSERT_EQ(2, init2->buf2.count());
+  EXPECT_DOUBLE_EQ(5, init2->buf2.quantity());
+
+  r.Close();
+  delete c;
+}
+
+static cy::RecBackend* branch_back = NULL;
+
+static cy::RecBackend* BranchBack(int i) {
+  std::stringstream ss;
+  ss << "branch" << i << ".sqlite";
+  branch_back = new cy::SqliteBack(ss.str());
+  return branch_back;
+}
+
+TEST_F(SimInitTest, ForkBranches) {
+  cy::PyStart();
+  remove("branch0.sqlite");
+  remove("branch1.sqlite");
+  int branch = cy::SimInit::ForkBranches(ctx, 2, 2, BranchBack);
+  if (branch >= 0) {
+    ti.RunSim();
+    rec.Close();
+    delete branch_back;
+    _exit(0);
+  }
+  cy::PyStop();
+
+  for (int i = 0; i < 2; ++i) {
+    std::stringstream ss;
+    ss << "branch" << i << ".sqlite";
+    cy::SqliteBack back(ss.str());
+    cy::QueryResult qr = back.Query("Info", NULL);
+    EXPECT_EQ("branch", qr.GetVal<std::string>("ParentType"));
+    EXPECT_EQ(2, qr.GetVal<int>("BranchTime"));
+    EXPECT_EQ(rec.sim_id(), qr.GetVal<boost::uuids::uuid>("ParentSimId"));
+    EXPECT_NE(rec.sim_id(), qr.GetVal<boost::uuids::uuid>("SimId"));
+    qr = back.Query("Finish", NULL);
+    EXPECT_EQ(4, qr.GetVal<int>("EndTime"));
+    qr = back.Query("Snapshots", NULL);
+    EXPECT_EQ(2, qr.GetVal<int>("Time", 0));
+    back.Close();
+    remove(ss.str().c_str());
+  }
+}
+
+TEST_F(SimInitTest, RestartBranch) {
+  std::map<std::string, double> prio;
+  prio["uox"] = 2;
+  prio["mox"] = 1;
+  ctx->solver(new cy::GreedySolver(false, new cy::GreedyPreconditioner(
+      prio, cy::GreedyPreconditioner::REVERSE)));
+
+  cy::PyStart();
+  remove("branch0.sqlite");
+  int branch = cy::SimInit::ForkBranches(ctx, 2, 1, BranchBack);
+  if (branch >= 0) {
+    ti.RunSim();
+    rec.Close();
+    delete branch_back;
+    _exit(0);
+  }
+  cy::PyStop();
+
+  // the branch's output holds all that is needed without the parent's
+  cy::SqliteBack back("branch0.sqlite");
+  cy::QueryResult qr = back.Query("Info", NULL);
+  boost::uuids::uuid simid = qr.GetVal<boost::uuids::uuid>("SimId");
+  cy::SimInit si;
+  si.Restart(&back, simid, 2);
+  cy::Context* init_ctx = si.context();
+
+  Inver* p1;
+  ASSERT_NO_THROW(p1 = init_ctx->CreateAgent<Inver>("proto1"));
+  EXPECT_EQ(23, p1->val1);
+  cy::Composition::Ptr c = init_ctx->GetRecipe("recipe1");
+  EXPECT_EQ(ctx->GetRecipe("recipe1")->id(), c->id());
+  EXPECT_EQ(2, c->mass().size());
+
+  // only the second agent is still alive at the branch time
+  std::set<Agent*> agents = agent_list(init_ctx);
+  std::vector<Inver*> alive;
+  std::set<Agent*>::iterator it;
+  for (it = agents.begin(); it != agents.end(); ++it) {
+    if ((*it)->enter_time() != -1) {
+      alive.push_back(dynamic_cast<Inver*>(*it));
+    }
+  }
+  ASSERT_EQ(1, alive.size());
+  EXPECT_EQ(26, alive[0]->val1);
+  EXPECT_EQ(1, alive[0]->buf1.count());
+  EXPECT_EQ(2, alive[0]->buf2.count());
+  EXPECT_DOUBLE_EQ(5, alive[0]->buf2.quantity());
+
+  EXPECT_EQ(1, build_queue(si.timer())[3].size());
+  EXPECT_EQ(1, decom_queue(si.timer())[2].size());
+
+  // the greedy preconditioner gets its commodity priorities back
+  qr = back.Query("CommodPriority", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    std::string commod = qr.GetVal<std::string>("Commodity", i);
+    EXPECT_DOUBLE_EQ(prio[commod], qr.GetVal<double>("SolutionPriority", i));
+  }
+
+  back.Close();
+  remove("branch0.sqlite");
+}
+
 TEST_F(SimInitTest, RestartSimInfo) {
   cy::PyStart();
   ti.RunSim();
@@ -576,3 +576,39 @@ TEST_F(SqliteBackTests, ListPairIntInt) {
   EXPECT_EQ(std::make_pair(4, 2), l.front());
   EXPECT_EQ(std::make_pair(5, 3), l.back());
 }
+
+TEST_F(SqliteBackTests, Long) {
+  int64_t big = (static_cast<int64_t>(1) << 40) + 7;
+
+  r.NewDatum("foo")
+      ->AddVal("bar", big)
+      ->Record();
+
+  r.Close();
+  EXPECT_EQ(cyclus::LONG, b->ColumnTypes("foo")["bar"]);
+
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("bar", "==", big));
+  cyclus::QueryResult qr = b->Query("foo", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  EXPECT_EQ(big, qr.GetVal<int64_t>("bar"));
+}
+
+TEST_F(SqliteBackTests, MapStrLong) {
+  int64_t big = (static_cast<int64_t>(1) << 40) + 7;
+  std::map<std::string, int64_t> m;
+  m["one"] = 1;
+  m["big"] = big;
+
+  r.NewDatum("monty")
+      ->AddVal("count", m)
+      ->Record();
+
+  r.Close();
+  EXPECT_EQ(cyclus::MAP_STRING_LONG, b->ColumnTypes("monty")["count"]);
+  cyclus::QueryResult qr = b->Query("monty", NULL);
+  m = qr.GetVal<std::map<std::string, int64_t> >("count", 0);
+
+  EXPECT_EQ(1, m["one"]);
+  EXPECT_EQ(big, m["big"]);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "pyne.h"
+#include "startup_profile.h"
+
+using cyclus::ProfileScope;
+using cyclus::StartupProfile;
+
+TEST(StartupProfileTests, Disabled) {
+  StartupProfile::Clear();
+  {
+    ProfileScope p("a");
+  }
+  EXPECT_EQ(0, StartupProfile::phases().size());
+}
+
+TEST(StartupProfileTests, Nesting) {
+  StartupProfile::Clear();
+  StartupProfile::Enable();
+  {
+    ProfileScope a("a");
+    {
+      ProfileScope b("b");
+      std::string big(1 << 20, 'x');
+    }
+    ProfileScope c("c");
+  }
+  {
+    ProfileScope d("d");
+  }
+  StartupProfile::Enable(false);
+
+  const std::vector<StartupProfile::Phase>& phases = StartupProfile::phases();
+  ASSERT_EQ(4, phases.size());
+  EXPECT_EQ("a", phases[0].name);
+  EXPECT_EQ(0, phases[0].depth);
+  EXPECT_EQ(1, phases[1].depth);
+  EXPECT_EQ(1, phases[2].depth);
+  EXPECT_EQ(0, phases[3].depth);
+  EXPECT_LE(phases[1].secs + phases[2].secs, phases[0].secs);
+  EXPECT_LE(phases[1].maxrss_kb, phases[2].maxrss_kb);
+
+  Json::Value root;
+  Json::Reader reader;
+  ASSERT_TRUE(reader.parse(StartupProfile::ToJson(), root));
+  ASSERT_EQ(2, root["phases"].size());
+  EXPECT_EQ("a", root["phases"][0]["name"].asString());
+  ASSERT_EQ(2, root["phases"][0]["children"].size());
+  EXPECT_EQ("c", root["phases"][0]["children"][1]["name"].asString());
+  EXPECT_EQ("d", root["phases"][1]["name"].asString());
+
+  EXPECT_NE(std::string::npos, StartupProfile::ToTable().find("  b"));
+  StartupProfile::Clear();
+}
@@ -217,6 +217,32 @@ def test_record_flush_thrice():
     rec.close()
 
 
+def test_repeated_values_and_growth():
+    n = 10
+    rec, back = make_rec_back(inject_sim_id=True)
+    for i in range(n):
+        d = rec.new_datum("test")
+        d.add_val("col0", i, type=ts.INT)
+        d.add_val("col1", "wakka" if i%2 == 0 else "jawaka", type=ts.VL_STRING)
+        d.record()
+    rec.flush()
+
+    obs = back.query("test")
+    assert_equal(n, len(obs))
+    assert_equal(1, len(obs["SimId"].unique()))
+    assert_equal(["wakka", "jawaka"]*(n//2), list(obs["col1"]))
+
+    # the frame is rebuilt once more rows are recorded
+    d = rec.new_datum("test")
+    d.add_val("col0", n, type=ts.INT)
+    d.add_val("col1", "wakka", type=ts.VL_STRING)
+    d.record()
+    rec.flush()
+    obs = back.query("test")
+    assert_equal(list(range(n + 1)), list(obs["col0"]))
+    rec.close()
+
+
 def test_many_cols_one_table():
     n = 100
     rec, back = make_rec_back()
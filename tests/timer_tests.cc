@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "context.h"
+#include "env.h"
 #include "facility.h"
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
+#include "material.h"
 #include "pyhooks.h"
 #include "recorder.h"
 #include "timer.h"
@@ -64,6 +66,33 @@ class Snapper : public cyclus::Facility {
   bool snap;
 };
 
+class Decayer : public cyclus::Facility {
+ public:
+  Decayer(cyclus::Context* ctx) : cyclus::Facility(ctx) {}
+  virtual ~Decayer() {}
+
+  virtual cyclus::Agent* Clone() { return new Decayer(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  void Tick() {
+    if (context()->time() == 0) {
+      cyclus::CompMap v;
+      v[902280000] = 1;
+      cyclus::Composition::Ptr c = cyclus::Composition::CreateFromMass(v);
+      m1 = cyclus::Material::Create(this, 1, c);
+      m2 = cyclus::Material::Create(this, 2, c);
+    }
+    // the first material decays, the second finds it in the decay chain
+    m1->comp();
+    m2->comp();
+  }
+  void Tock() {}
+
+  cyclus::Material::Ptr m1;
+  cyclus::Material::Ptr m2;
+};
+
 TEST(TimerTests, BareSim) {
   cyclus::PyStart();
   cyclus::Recorder rec;
@@ -149,6 +178,90 @@ TEST(TimerTests, CustomSnapshot) {
   cyclus::PyStop();
 }
 
+TEST(TimerTests, CheckpointInterval) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  cyclus::SimInfo si(10);
+  si.checkpoint_interval = 4;
+  ti.Initialize(&ctx, si);
+
+  Snapper* turtle = new Snapper(&ctx);
+  turtle->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  cyclus::QueryResult qr = b.Query("Snapshots", NULL);
+  EXPECT_EQ(3, qr.rows.size());
+  EXPECT_EQ(4, qr.GetVal<int>("Time", 0));
+  EXPECT_EQ(8, qr.GetVal<int>("Time", 1));
+  EXPECT_EQ(10, qr.GetVal<int>("Time", 2));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, CheckpointBackoff) {
+  cyclus::PyStart();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  // every checkpoint is slow, so the first one stretches the interval
+  // past the end of the simulation
+  cyclus::SimInfo si(10);
+  si.checkpoint_interval = 1;
+  si.checkpoint_backoff = 1e-9;
+  ti.Initialize(&ctx, si);
+
+  Snapper* turtle = new Snapper(&ctx);
+  turtle->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  cyclus::QueryResult qr = b.Query("Snapshots", NULL);
+  EXPECT_EQ(2, qr.rows.size());
+  EXPECT_EQ(1, qr.GetVal<int>("Time", 0));
+  EXPECT_EQ(10, qr.GetVal<int>("Time", 1));
+  cyclus::PyStop();
+}
+
+TEST(TimerTests, DecayStats) {
+  cyclus::PyStart();
+  cyclus::Env::SetNucDataPath();
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+  cyclus::SqliteBack b(path);
+  rec.RegisterBackend(&b);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3, 2015, 1, "", "lazy"));
+  cyclus::Composition::decay_stats() = cyclus::Composition::DecayStats();
+
+  Decayer* d = new Decayer(&ctx);
+  d->Build(NULL);
+
+  ti.RunSim();
+  rec.Close();
+
+  // nothing needs to decay in the first time step
+  cyclus::QueryResult qr = b.Query("DecayStats", NULL);
+  ASSERT_EQ(2, qr.rows.size());
+  for (int i = 0; i < qr.rows.size(); ++i) {
+    EXPECT_EQ(i + 1, qr.GetVal<int>("Time", i));
+    EXPECT_EQ(1, qr.GetVal<int64_t>("Hits", i));
+    EXPECT_EQ(1, qr.GetVal<int64_t>("Misses", i));
+    EXPECT_DOUBLE_EQ(0.5, qr.GetVal<double>("HitRate", i));
+  }
+  cyclus::PyStop();
+}
+
 TEST(TimerTests, NullParentDecomNoSegfault) {
   cyclus::PyStart();
   cyclus::Recorder rec;
@@ -355,5 +355,39 @@ TEST_F(ResBufTest, PushAll_DuplicateEmpty) {
   EXPECT_DOUBLE_EQ(store_.quantity(), mat1_->quantity() + mat2_->quantity());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResBufTest, FifoManyEmpty) {
+  // interleave pushes and pops so that the ring buffer wraps around and grows
+  // while holding thousands of resources.
+  int n = 5000;
+  ProdVec pushed;
+  for (int i = 0; i < n; i++) {
+    Product::Ptr p = Product::CreateUntracked(1, "bananas");
+    pushed.push_back(p);
+    ASSERT_NO_THROW(store_.Push(p));
+    if (i % 3 == 2) {
+      ASSERT_EQ(store_.Pop(), pushed[i / 3]);
+    }
+  }
+  int popped = n / 3;
+  ASSERT_EQ(store_.count(), n - popped);
+  EXPECT_DOUBLE_EQ(store_.quantity(), n - popped);
+  ASSERT_THROW(store_.Push(pushed[n - 1]), KeyError);
+  ASSERT_NO_THROW(store_.Push(pushed[0]));
+  ASSERT_EQ(store_.PopBack(), pushed[0]);
+
+  ProdVec batch = store_.PopN(1000);
+  for (int i = 0; i < batch.size(); i++) {
+    ASSERT_EQ(batch[i], pushed[popped + i]);
+  }
+  popped += batch.size();
+
+  Product::Ptr p = store_.Pop(1000.5);
+  EXPECT_DOUBLE_EQ(p->quantity(), 1000.5);
+  EXPECT_DOUBLE_EQ(store_.Peek()->quantity(), 0.5);
+  ASSERT_EQ(store_.count(), n - popped - 1000);
+  EXPECT_DOUBLE_EQ(store_.quantity(), n - popped - 1000.5);
+}
+
 }  // namespace toolkit
 }  // namespace cyclus
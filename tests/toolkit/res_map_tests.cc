@@ -39,7 +39,7 @@ TEST_F(ResMapTest, GetSizeFilled) {
 
 
 TEST_F(ResMapTest, ObjIds) {
-  std::map<std::string, int> oids;
+  std::map<std::string, int64_t> oids;
   ASSERT_NO_THROW(oids = filled_store_.obj_ids());
   ASSERT_NO_THROW(store_.obj_ids(oids));
 }
@@ -1,15 +1,20 @@
 #include "xml_file_loader_tests.h"
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <string>
 
+#include <boost/filesystem.hpp>
+
 #include "agent.h"
 #include "dynamic_module.h"
 #include "env.h"
 #include "error.h"
 #include "sqlite_back.h"
+#include "toolkit/infile_converters.h"
 
 using namespace std;
 using cyclus::XMLFileLoader;
@@ -265,11 +270,126 @@ TEST_F(XMLFileLoaderTests, EpsFile) {
   EXPECT_DOUBLE_EQ(3e-4, cyclus::eps_rsrc());
 }
 
+TEST_F(XMLFileLoaderTests, InputCache) {
+  namespace fs = boost::filesystem;
+  fs::path cache = "xmlfileloadtestcache";
+  fs::remove_all(cache);
+  setenv("CYCLUS_INPUT_CACHE", cache.string().c_str(), 1);
+
+  XMLFileLoader file(&rec_, b_, schema_path, eps_file);
+  file.LoadSim();
+  ASSERT_TRUE(fs::exists(cache));
+  EXPECT_EQ(1, std::distance(fs::directory_iterator(cache),
+                             fs::directory_iterator()));
+
+  // the same input is not validated again
+  cyclus::Recorder rec;
+  cyclus::SqliteBack b(":memory:");
+  rec.RegisterBackend(&b);
+  XMLFileLoader again(&rec, &b, schema_path, eps_file);
+  EXPECT_NO_THROW(again.LoadSim());
+  EXPECT_EQ(1, std::distance(fs::directory_iterator(cache),
+                             fs::directory_iterator()));
+  rec.Close();
+
+  unsetenv("CYCLUS_INPUT_CACHE");
+  fs::remove_all(cache);
+}
+
+/// Exposes the input cache key of a loader.
+class CacheKeyLoader : public XMLFileLoader {
+ public:
+  CacheKeyLoader(cyclus::Recorder* r, cyclus::QueryableBackend* b,
+                 std::string schema_file, std::string input)
+      : XMLFileLoader(r, b, schema_file, input, "xml") {}
+
+  std::string key() { return InputCacheKey(); }
+};
+
+TEST_F(XMLFileLoaderTests, InputCacheHit) {
+  namespace fs = boost::filesystem;
+  fs::path cache = "xmlfileloadtestcache";
+  fs::remove_all(cache);
+  setenv("CYCLUS_INPUT_CACHE", cache.string().c_str(), 1);
+
+  // an element the schema does not allow, but that the loader ignores
+  std::string input = ControlSequenceWithEps();
+  std::string ctrl = "<control>";
+  input.insert(input.find(ctrl) + ctrl.size(), "<bogus>1</bogus>");
+  CacheKeyLoader invalid(&rec_, b_, schema_path, input);
+  std::string generated = invalid.key();
+  EXPECT_THROW(invalid.LoadSim(), cyclus::ValidationError);
+
+  // a cache hit skips validation altogether
+  cyclus::Recorder rec;
+  cyclus::SqliteBack b(":memory:");
+  rec.RegisterBackend(&b);
+  CacheKeyLoader hit(&rec, &b, schema_path, input);
+  fs::create_directories(cache);
+  std::ofstream marker((cache / (hit.key() + ".valid")).string().c_str());
+  marker.close();
+  EXPECT_NO_THROW(hit.LoadSim());
+  rec.Close();
+
+  // the schema digests of the archetypes were cached by library file, and
+  // give the same key as generating the schemas
+  int nschemas = std::distance(fs::directory_iterator(cache / "schemas"),
+                               fs::directory_iterator());
+  EXPECT_EQ(4, nschemas);
+  EXPECT_EQ(generated, hit.key());
+
+  unsetenv("CYCLUS_INPUT_CACHE");
+  fs::remove_all(cache);
+}
+
 TEST_F(XMLFileLoaderTests, ExplicitFormat) {
   EXPECT_NO_THROW(XMLFileLoader file(&rec_, b_, schema_path, 
                                      XMLFileLoaderTests::ControlSequenceWithEps(), "xml"));
 }
 
+TEST_F(XMLFileLoaderTests, JsonInput) {
+  std::string json = cyclus::toolkit::XmlToJson(ControlSequenceWithEps());
+  XMLFileLoader file(&rec_, b_, schema_path, json, "json");
+  file.LoadSim();
+
+  EXPECT_DOUBLE_EQ(0.5e-5, cyclus::eps());
+  EXPECT_DOUBLE_EQ(3e-4, cyclus::eps_rsrc());
+}
+
+TEST_F(XMLFileLoaderTests, DuplicateConfigs) {
+  std::string input = ControlSequenceWithEps();
+  input.insert(input.find("  <region>"),
+               "  <facility>"
+               "    <name>src2</name>"
+               "    <lifetime>2</lifetime>"
+               "    <config>"
+               "      <Source>"
+               "        <commod>commod</commod>"
+               "        <capacity>1</capacity>"
+               "      </Source>"
+               "    </config>"
+               "  </facility>");
+  XMLFileLoader file(&rec_, b_, schema_path, input, "xml");
+  file.LoadSim();
+
+  // the cloned prototype still gets its own name, lifetime and state rows
+  std::vector<cyclus::Cond> conds;
+  conds.push_back(cyclus::Cond("Prototype", "==", std::string("src2")));
+  cyclus::QueryResult qr = b_->Query("Prototypes", &conds);
+  ASSERT_EQ(1, qr.rows.size());
+  int id = qr.GetVal<int>("AgentId");
+
+  conds.clear();
+  conds.push_back(cyclus::Cond("AgentId", "==", id));
+  qr = b_->Query("AgentStateAgent", &conds);
+  ASSERT_LT(0, qr.rows.size());
+  EXPECT_EQ(2, qr.GetVal<int>("Lifetime"));
+  qr = b_->Query("AgentState_agents_SourceInfo", &conds);
+  ASSERT_LT(0, qr.rows.size());
+  EXPECT_EQ("commod", qr.GetVal<std::string>("commod"));
+  EXPECT_DOUBLE_EQ(1, qr.GetVal<double>("capacity"));
+}
+
 TEST_F(XMLFileLoaderTests, throws) {
   EXPECT_THROW(XMLFileLoader file(&rec_, b_, schema_path, "blah"), cyclus::IOError);
 }